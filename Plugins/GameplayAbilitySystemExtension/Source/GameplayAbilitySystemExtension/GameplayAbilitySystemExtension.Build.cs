@@ -46,7 +46,9 @@ public class GameplayAbilitySystemExtension : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				"DeveloperSettings"
+				"DeveloperSettings",
+				"Json",
+				"NetCore"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
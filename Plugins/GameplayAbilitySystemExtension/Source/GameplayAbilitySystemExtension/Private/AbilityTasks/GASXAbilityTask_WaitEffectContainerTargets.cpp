@@ -0,0 +1,68 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "AbilityTasks/GASXAbilityTask_WaitEffectContainerTargets.h"
+#include "GameplayAbilities/GASXGameplayAbility.h"
+#include "GASXTargetType.h"
+
+UGASXAbilityTask_WaitEffectContainerTargets::UGASXAbilityTask_WaitEffectContainerTargets(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, OverrideGameplayLevel(INDEX_NONE)
+{
+}
+
+UGASXAbilityTask_WaitEffectContainerTargets* UGASXAbilityTask_WaitEffectContainerTargets::WaitEffectContainerTargets(UGameplayAbility* OwningAbility, const FGASXGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel)
+{
+	UGASXAbilityTask_WaitEffectContainerTargets* MyObj = NewAbilityTask<UGASXAbilityTask_WaitEffectContainerTargets>(OwningAbility);
+
+	MyObj->Container = Container;
+	MyObj->EventData = EventData;
+	MyObj->OverrideGameplayLevel = OverrideGameplayLevel;
+
+	return MyObj;
+}
+
+void UGASXAbilityTask_WaitEffectContainerTargets::Activate()
+{
+	UGASXGameplayAbility* GASXAbility = Cast<UGASXGameplayAbility>(Ability);
+	const FGameplayAbilityActorInfo* ActorInfo = Ability ? Ability->GetCurrentActorInfo() : nullptr;
+	if (!GASXAbility || !ActorInfo)
+	{
+		EndTask();
+		return;
+	}
+
+	ContainerSpec = GASXAbility->MakeEffectContainerSpecWithoutTargets(Container, OverrideGameplayLevel);
+
+	if (const UGASXTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject())
+	{
+		TargetTypeCDO->GetTargetsAsync(*ActorInfo, EventData, FGASXTargetsReadyDelegate::CreateUObject(this, &UGASXAbilityTask_WaitEffectContainerTargets::HandleTargetsReady));
+		return;
+	}
+
+	// No targeting logic, so there is nothing to wait for.
+	HandleTargetsReady(TArray<FHitResult>(), TArray<AActor*>());
+}
+
+void UGASXAbilityTask_WaitEffectContainerTargets::HandleTargetsReady(const TArray<FHitResult>& HitResults, const TArray<AActor*>& Actors)
+{
+	if (IsFinished())
+	{
+		return;
+	}
+
+	ContainerSpec.AddTargets(HitResults, Actors);
+
+	if (ShouldBroadcastAbilityTaskDelegates())
+	{
+		OnTargetsReady.Broadcast(ContainerSpec);
+	}
+	EndTask();
+}
+
+FString UGASXAbilityTask_WaitEffectContainerTargets::GetDebugString() const
+{
+	return FString::Printf(TEXT("WaitEffectContainerTargets. TargetType: %s. Effects: %d.")
+		, *GetNameSafe(Container.TargetType.Get())
+		, Container.TargetGameplayEffectClasses.Num()
+	);
+}
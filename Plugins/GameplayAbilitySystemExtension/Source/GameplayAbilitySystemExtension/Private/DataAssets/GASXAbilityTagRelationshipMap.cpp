@@ -2,58 +2,130 @@
 
 #include "DataAssets/GASXAbilityTagRelationshipMap.h"
 
-void UGASXAbilityTagRelationshipMap::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+void FGASXAbilityTagRelationshipTags::Append(const FAbilityTagRelationship& Relationship)
+{
+	CancelAbilitiesWithTag.AppendTags(Relationship.CancelAbilitiesWithTag);
+	BlockAbilitiesWithTag.AppendTags(Relationship.BlockAbilitiesWithTag);
+	ActivationRequiredTags.AppendTags(Relationship.ActivationRequiredTags);
+	ActivationBlockedTags.AppendTags(Relationship.ActivationBlockedTags);
+}
+
+void FGASXAbilityTagRelationshipTags::Append(const FGASXAbilityTagRelationshipTags& Other)
+{
+	CancelAbilitiesWithTag.AppendTags(Other.CancelAbilitiesWithTag);
+	BlockAbilitiesWithTag.AppendTags(Other.BlockAbilitiesWithTag);
+	ActivationRequiredTags.AppendTags(Other.ActivationRequiredTags);
+	ActivationBlockedTags.AppendTags(Other.ActivationBlockedTags);
+}
+
+uint32 UGASXAbilityTagRelationshipMap::FAbilityTagsKeyFuncs::GetKeyHash(const FGameplayTagContainer& Key)
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	uint32 Hash = 0;
+	for (const FGameplayTag& Tag : Key)
 	{
-		const FAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
-		{
-			if (OutTagsToBlock)
-			{
-				OutTagsToBlock->AppendTags(Tags.BlockAbilitiesWithTag);
-			}
-			if (OutTagsToCancel)
-			{
-				OutTagsToCancel->AppendTags(Tags.CancelAbilitiesWithTag);
-			}
-		}
+		Hash += GetTypeHash(Tag);
 	}
+	return Hash;
 }
 
-void UGASXAbilityTagRelationshipMap::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+void UGASXAbilityTagRelationshipMap::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileRelationships();
+}
+
+#if WITH_EDITOR
+void UGASXAbilityTagRelationshipMap::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	CompileRelationships();
+}
+#endif
+
+void UGASXAbilityTagRelationshipMap::SetAbilityTagRelationships(TArray<FAbilityTagRelationship> InRelationships)
+{
+	AbilityTagRelationships = MoveTemp(InRelationships);
+	CompileRelationships();
+}
+
+void UGASXAbilityTagRelationshipMap::CompileRelationships()
+{
+	CompiledRelationships.Reset();
+	CachedAbilityTags.Reset();
+
+	for (const FAbilityTagRelationship& Relationship : AbilityTagRelationships)
 	{
-		const FAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		if (Relationship.AbilityTag.IsValid())
 		{
-			if (OutActivationRequired)
-			{
-				OutActivationRequired->AppendTags(Tags.ActivationRequiredTags);
-			}
-			if (OutActivationBlocked)
-			{
-				OutActivationBlocked->AppendTags(Tags.ActivationBlockedTags);
-			}
+			CompiledRelationships.FindOrAdd(Relationship.AbilityTag).Append(Relationship);
 		}
 	}
+
+	bCompiled = true;
 }
 
-bool UGASXAbilityTagRelationshipMap::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
+const FGASXAbilityTagRelationshipTags& UGASXAbilityTagRelationshipMap::GetRelationshipTags(const FGameplayTagContainer& AbilityTags) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	if (const FGASXAbilityTagRelationshipTags* Cached = CachedAbilityTags.Find(AbilityTags))
+	{
+		return *Cached;
+	}
+
+	// e.g. created with NewObject() and filled without SetAbilityTagRelationships()
+	if (!bCompiled)
 	{
-		const FAbilityTagRelationship& Tags = AbilityTagRelationships[i];
+		const_cast<UGASXAbilityTagRelationshipMap*>(this)->CompileRelationships();
+	}
 
-		if (Tags.AbilityTag == ActionTag && Tags.CancelAbilitiesWithTag.HasAny(AbilityTags))
+	// Same as AbilityTags.HasTag(Relationship.AbilityTag) for every relationship: a relationship applies to its AbilityTag and every child of it.
+	FGASXAbilityTagRelationshipTags Result;
+	for (const FGameplayTag& Tag : AbilityTags.GetGameplayTagParents())
+	{
+		if (const FGASXAbilityTagRelationshipTags* Compiled = CompiledRelationships.Find(Tag))
 		{
-			return true;
+			Result.Append(*Compiled);
 		}
 	}
 
-	return false;
+	return CachedAbilityTags.Add(AbilityTags, MoveTemp(Result));
+}
+
+void UGASXAbilityTagRelationshipMap::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+{
+	const FGASXAbilityTagRelationshipTags& Tags = GetRelationshipTags(AbilityTags);
+	if (OutTagsToBlock)
+	{
+		OutTagsToBlock->AppendTags(Tags.BlockAbilitiesWithTag);
+	}
+	if (OutTagsToCancel)
+	{
+		OutTagsToCancel->AppendTags(Tags.CancelAbilitiesWithTag);
+	}
+}
+
+void UGASXAbilityTagRelationshipMap::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+{
+	const FGASXAbilityTagRelationshipTags& Tags = GetRelationshipTags(AbilityTags);
+	if (OutActivationRequired)
+	{
+		OutActivationRequired->AppendTags(Tags.ActivationRequiredTags);
+	}
+	if (OutActivationBlocked)
+	{
+		OutActivationBlocked->AppendTags(Tags.ActivationBlockedTags);
+	}
+}
+
+bool UGASXAbilityTagRelationshipMap::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
+{
+	if (!bCompiled)
+	{
+		const_cast<UGASXAbilityTagRelationshipMap*>(this)->CompileRelationships();
+	}
+
+	// Exact match on ActionTag, unlike the lookups above.
+	const FGASXAbilityTagRelationshipTags* Compiled = CompiledRelationships.Find(ActionTag);
+	return Compiled && Compiled->CancelAbilitiesWithTag.HasAny(AbilityTags);
 }
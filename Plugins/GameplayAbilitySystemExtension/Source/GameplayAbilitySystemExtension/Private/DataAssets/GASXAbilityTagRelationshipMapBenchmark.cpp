@@ -0,0 +1,199 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "DataAssets/GASXAbilityTagRelationshipMap.h"
+#include "GASXMacroDefinitions.h"
+#include "GameplayTagsManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "UObject/StrongObjectPtr.h"
+
+/**
+ * Benchmark of UGASXAbilityTagRelationshipMap lookups against the previous iteration over every relationship.
+ *
+ * Usage: gasx.TagRelationships.Benchmark [NumRelationships=1000] [NumAbilities=50] [Iterations=10000]
+ *
+ * Relationships and ability tag sets are made from random registered gameplay tags, so the project needs enough tags for the results to mean anything.
+ */
+namespace GASXTagRelationshipBenchmark
+{
+	// What the lookups did before relationships were compiled, kept as the baseline.
+	static void IterateRelationships(const TArray<FAbilityTagRelationship>& Relationships, const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutBlock, FGameplayTagContainer& OutCancel, FGameplayTagContainer& OutRequired, FGameplayTagContainer& OutBlocked)
+	{
+		for (const FAbilityTagRelationship& Relationship : Relationships)
+		{
+			if (AbilityTags.HasTag(Relationship.AbilityTag))
+			{
+				OutBlock.AppendTags(Relationship.BlockAbilitiesWithTag);
+				OutCancel.AppendTags(Relationship.CancelAbilitiesWithTag);
+				OutRequired.AppendTags(Relationship.ActivationRequiredTags);
+				OutBlocked.AppendTags(Relationship.ActivationBlockedTags);
+			}
+		}
+	}
+
+	static bool IterateIsCancelledByTag(const TArray<FAbilityTagRelationship>& Relationships, const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag)
+	{
+		for (const FAbilityTagRelationship& Relationship : Relationships)
+		{
+			if (Relationship.AbilityTag == ActionTag && Relationship.CancelAbilitiesWithTag.HasAny(AbilityTags))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static FGameplayTagContainer MakeRandomContainer(const TArray<FGameplayTag>& Tags, FRandomStream& Random, int32 NumTags)
+	{
+		FGameplayTagContainer Container;
+		for (int32 Index = 0; Index < NumTags; ++Index)
+		{
+			Container.AddTag(Tags[Random.RandHelper(Tags.Num())]);
+		}
+		return Container;
+	}
+
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		int32 NumRelationships = 1000;
+		int32 NumAbilities = 50;
+		int32 Iterations = 10000;
+		for (const FString& Arg : Args)
+		{
+			FParse::Value(*Arg, TEXT("NumRelationships="), NumRelationships);
+			FParse::Value(*Arg, TEXT("NumAbilities="), NumAbilities);
+			FParse::Value(*Arg, TEXT("Iterations="), Iterations);
+		}
+		NumRelationships = FMath::Max(NumRelationships, 1);
+		NumAbilities = FMath::Max(NumAbilities, 1);
+
+		FGameplayTagContainer AllTags;
+		UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, true);
+		TArray<FGameplayTag> Tags;
+		AllTags.GetGameplayTagArray(Tags);
+		if (Tags.Num() < 2)
+		{
+			UE_LOG(LogGASX, Warning, TEXT("gasx.TagRelationships.Benchmark: Not enough gameplay tags registered."));
+			return;
+		}
+
+		FRandomStream Random(1234);
+		TArray<FAbilityTagRelationship> Relationships;
+		Relationships.Reserve(NumRelationships);
+		for (int32 Index = 0; Index < NumRelationships; ++Index)
+		{
+			FAbilityTagRelationship& Relationship = Relationships.AddDefaulted_GetRef();
+			Relationship.AbilityTag = Tags[Random.RandHelper(Tags.Num())];
+			Relationship.CancelAbilitiesWithTag = MakeRandomContainer(Tags, Random, 2);
+			Relationship.BlockAbilitiesWithTag = MakeRandomContainer(Tags, Random, 2);
+			Relationship.ActivationRequiredTags = MakeRandomContainer(Tags, Random, 1);
+			Relationship.ActivationBlockedTags = MakeRandomContainer(Tags, Random, 1);
+		}
+
+		TArray<FGameplayTagContainer> AbilityTagSets;
+		for (int32 Index = 0; Index < NumAbilities; ++Index)
+		{
+			AbilityTagSets.Add(MakeRandomContainer(Tags, Random, 1 + Random.RandHelper(3)));
+		}
+
+		TStrongObjectPtr<UGASXAbilityTagRelationshipMap> Map(NewObject<UGASXAbilityTagRelationshipMap>());
+
+		const double CompileStart = FPlatformTime::Seconds();
+		Map->SetAbilityTagRelationships(Relationships);
+		const double CompileSeconds = FPlatformTime::Seconds() - CompileStart;
+
+		// Results are checked against the baseline once, then everything is timed.
+		int32 NumMismatches = 0;
+		for (const FGameplayTagContainer& AbilityTags : AbilityTagSets)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			IterateRelationships(Relationships, AbilityTags, Block, Cancel, Required, Blocked);
+			const FGASXAbilityTagRelationshipTags& Compiled = Map->GetRelationshipTags(AbilityTags);
+			if (Block != Compiled.BlockAbilitiesWithTag || Cancel != Compiled.CancelAbilitiesWithTag
+				|| Required != Compiled.ActivationRequiredTags || Blocked != Compiled.ActivationBlockedTags)
+			{
+				++NumMismatches;
+			}
+		}
+		for (int32 Index = 0; Index < Relationships.Num(); ++Index)
+		{
+			const FGameplayTagContainer& AbilityTags = AbilityTagSets[Index % AbilityTagSets.Num()];
+			if (IterateIsCancelledByTag(Relationships, AbilityTags, Relationships[Index].AbilityTag) != Map->IsAbilityCancelledByTag(AbilityTags, Relationships[Index].AbilityTag))
+			{
+				++NumMismatches;
+			}
+		}
+
+		const double IterateStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			IterateRelationships(Relationships, AbilityTagSets[Iteration % AbilityTagSets.Num()], Block, Cancel, Required, Blocked);
+		}
+		const double IterateSeconds = FPlatformTime::Seconds() - IterateStart;
+
+		const double CachedStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			Map->GetAbilityTagsToBlockAndCancel(AbilityTagSets[Iteration % AbilityTagSets.Num()], &Block, &Cancel);
+			Map->GetRequiredAndBlockedActivationTags(AbilityTagSets[Iteration % AbilityTagSets.Num()], &Required, &Blocked);
+		}
+		const double CachedSeconds = FPlatformTime::Seconds() - CachedStart;
+
+		// Cancel checks by an action tag, e.g. when an ability activates.
+		int32 NumCancelled = 0;
+		const double IterateCancelStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			NumCancelled += IterateIsCancelledByTag(Relationships, AbilityTagSets[Iteration % AbilityTagSets.Num()], Relationships[Iteration % Relationships.Num()].AbilityTag) ? 1 : 0;
+		}
+		const double IterateCancelSeconds = FPlatformTime::Seconds() - IterateCancelStart;
+
+		const double CompiledCancelStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			NumCancelled += Map->IsAbilityCancelledByTag(AbilityTagSets[Iteration % AbilityTagSets.Num()], Relationships[Iteration % Relationships.Num()].AbilityTag) ? 1 : 0;
+		}
+		const double CompiledCancelSeconds = FPlatformTime::Seconds() - CompiledCancelStart;
+
+		// Every lookup misses the cache, i.e. the compiled map alone.
+		const double UncachedStart = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			if (Iteration % AbilityTagSets.Num() == 0)
+			{
+				Map->ClearCachedLookups();
+			}
+			FGameplayTagContainer Block, Cancel, Required, Blocked;
+			Map->GetAbilityTagsToBlockAndCancel(AbilityTagSets[Iteration % AbilityTagSets.Num()], &Block, &Cancel);
+			Map->GetRequiredAndBlockedActivationTags(AbilityTagSets[Iteration % AbilityTagSets.Num()], &Required, &Blocked);
+		}
+		const double UncachedSeconds = FPlatformTime::Seconds() - UncachedStart;
+
+		const double ToUsPerLookup = 1e6 / FMath::Max(Iterations, 1);
+		UE_LOG(LogGASX, Display, TEXT("Tag relationship benchmark: %d relationships, %d ability tag sets, %d tags, %d iterations"), NumRelationships, NumAbilities, Tags.Num(), Iterations);
+		UE_LOG(LogGASX, Display, TEXT("  Compile:           %10.3f ms"), CompileSeconds * 1000.0);
+		UE_LOG(LogGASX, Display, TEXT("  Iteration:         %10.3f us per lookup"), IterateSeconds * ToUsPerLookup);
+		UE_LOG(LogGASX, Display, TEXT("  Compiled:          %10.3f us per lookup"), UncachedSeconds * ToUsPerLookup);
+		UE_LOG(LogGASX, Display, TEXT("  Compiled + cached: %10.3f us per lookup"), CachedSeconds * ToUsPerLookup);
+		UE_LOG(LogGASX, Display, TEXT("  Cancelled by tag, iteration: %10.3f us per check"), IterateCancelSeconds * ToUsPerLookup);
+		UE_LOG(LogGASX, Display, TEXT("  Cancelled by tag, compiled:  %10.3f us per check (%d cancelled)"), CompiledCancelSeconds * ToUsPerLookup, NumCancelled);
+		if (NumMismatches > 0)
+		{
+			UE_LOG(LogGASX, Error, TEXT("  %d lookups got different results from the compiled map than from iteration."), NumMismatches);
+		}
+	}
+
+	static FAutoConsoleCommand CmdTagRelationshipsBenchmark(
+		TEXT("gasx.TagRelationships.Benchmark"),
+		TEXT("Times UGASXAbilityTagRelationshipMap lookups against iterating every relationship. Args: [NumRelationships=1000] [NumAbilities=50] [Iterations=10000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(RunBenchmark));
+}
+
+#endif // !UE_BUILD_SHIPPING
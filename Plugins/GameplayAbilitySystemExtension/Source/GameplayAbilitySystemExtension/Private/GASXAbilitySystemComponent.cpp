@@ -6,6 +6,7 @@
 #include "DataAssets/GASXAbilityTagRelationshipMap.h"
 #include "DataAssets/GASXAbilitySet.h"
 #include "DataAssets/GASXInputConfig.h"
+#include "Engine/World.h"
 
 UGASXAbilitySystemComponent::UGASXAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -13,6 +14,12 @@ UGASXAbilitySystemComponent::UGASXAbilitySystemComponent(const FObjectInitialize
 	InputPressedSpecHandles.Reset();
 	InputReleasedSpecHandles.Reset();
 	InputHeldSpecHandles.Reset();
+	InputHandledSpecHandles.Reset();
+
+	// Fired when a tag is newly added or fully removed, from any source, including SetTagMapCount() for loose and replicated tags,
+	// and BlockAbilitiesWithTags() from outside ApplyAbilityBlockAndCancelTags(), e.g. by UBlockAbilityTagsGameplayEffectComponent.
+	RegisterGenericGameplayTagEvent().AddUObject(this, &UGASXAbilitySystemComponent::OnOwnedOrBlockedTagChanged);
+	BlockedAbilityTags.RegisterGenericGameplayEvent().AddUObject(this, &UGASXAbilitySystemComponent::OnOwnedOrBlockedTagChanged);
 }
 
 void UGASXAbilitySystemComponent::GetAbilityTargetData(const FGameplayAbilitySpecHandle AbilityHandle, FGameplayAbilityActivationInfo ActivationInfo, FGameplayAbilityTargetDataHandle& OutTargetDataHandle)
@@ -27,6 +34,7 @@ void UGASXAbilitySystemComponent::GetAbilityTargetData(const FGameplayAbilitySpe
 void UGASXAbilitySystemComponent::SetTagRelationshipMapping(UGASXAbilityTagRelationshipMap* NewMapping)
 {
 	TagRelationshipMapping = NewMapping;
+	++OwnedTagsGeneration;
 }
 
 void UGASXAbilitySystemComponent::GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const
@@ -39,16 +47,23 @@ void UGASXAbilitySystemComponent::GetAdditionalActivationTagRequirements(const F
 
 void UGASXAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags)
 {
-	FGameplayTagContainer ModifiedBlockTags = BlockTags;
-	FGameplayTagContainer ModifiedCancelTags = CancelTags;
-
 	if (TagRelationshipMapping)
 	{
-		// Use the mapping to expand the ability tags into block and cancel tag
-		TagRelationshipMapping->GetAbilityTagsToBlockAndCancel(AbilityTags, &ModifiedBlockTags, &ModifiedCancelTags);
+		// Use the mapping to expand the ability tags into block and cancel tag. Only copy the tags if the mapping adds any.
+		const FGASXAbilityTagRelationshipTags& RelationshipTags = TagRelationshipMapping->GetRelationshipTags(AbilityTags);
+		if (!RelationshipTags.BlockAbilitiesWithTag.IsEmpty() || !RelationshipTags.CancelAbilitiesWithTag.IsEmpty())
+		{
+			FGameplayTagContainer ModifiedBlockTags = BlockTags;
+			FGameplayTagContainer ModifiedCancelTags = CancelTags;
+			ModifiedBlockTags.AppendTags(RelationshipTags.BlockAbilitiesWithTag);
+			ModifiedCancelTags.AppendTags(RelationshipTags.CancelAbilitiesWithTag);
+
+			Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, ModifiedBlockTags, bExecuteCancelTags, ModifiedCancelTags);
+			return;
+		}
 	}
 
-	Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, ModifiedBlockTags, bExecuteCancelTags, ModifiedCancelTags);
+	Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, BlockTags, bExecuteCancelTags, CancelTags);
 
 	//@TODO: Apply any special logic like blocking input or movement
 }
@@ -57,12 +72,14 @@ void UGASXAbilitySystemComponent::AbilityInputTagPressed(const FGameplayTag& Inp
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		BufferInput(InputTag, true);
+
+		if (const auto* SpecHandles = InputTagToSpecHandles.Find(InputTag))
 		{
-			if (AbilitySpec.Ability && (AbilitySpec.DynamicAbilityTags.HasTagExact(InputTag)))
+			for (const FGameplayAbilitySpecHandle& SpecHandle : *SpecHandles)
 			{
-				InputPressedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.AddUnique(AbilitySpec.Handle);
+				InputPressedSpecHandles.AddUnique(SpecHandle);
+				InputHeldSpecHandles.AddUnique(SpecHandle);
 			}
 		}
 	}
@@ -72,17 +89,105 @@ void UGASXAbilitySystemComponent::AbilityInputTagReleased(const FGameplayTag& In
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		BufferInput(InputTag, false);
+
+		if (const auto* SpecHandles = InputTagToSpecHandles.Find(InputTag))
 		{
-			if (AbilitySpec.Ability && (AbilitySpec.DynamicAbilityTags.HasTagExact(InputTag)))
+			for (const FGameplayAbilitySpecHandle& SpecHandle : *SpecHandles)
 			{
-				InputReleasedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.Remove(AbilitySpec.Handle);
+				InputReleasedSpecHandles.AddUnique(SpecHandle);
+				InputHeldSpecHandles.Remove(SpecHandle);
 			}
 		}
 	}
 }
 
+FGameplayAbilitySpec* UGASXAbilitySystemComponent::FindAbilitySpecFromHandleIndexed(FGameplayAbilitySpecHandle Handle)
+{
+	FIndexedAbilitySpec* IndexedSpec = IndexedSpecs.Find(Handle);
+	if (!IndexedSpec)
+	{
+		// Every given ability goes through OnGiveAbility(), so it would be indexed.
+		return nullptr;
+	}
+	if (ActivatableAbilities.Items.IsValidIndex(IndexedSpec->Index) && ActivatableAbilities.Items[IndexedSpec->Index].Handle == Handle)
+	{
+		return &ActivatableAbilities.Items[IndexedSpec->Index];
+	}
+
+	// The index is stale, e.g. another spec was removed and this one was swapped into its place.
+	IndexedSpec->Index = ActivatableAbilities.Items.IndexOfByPredicate([Handle](const FGameplayAbilitySpec& AbilitySpec) { return AbilitySpec.Handle == Handle; });
+	return IndexedSpec->Index != INDEX_NONE ? &ActivatableAbilities.Items[IndexedSpec->Index] : nullptr;
+}
+
+void UGASXAbilitySystemComponent::UpdateAbilitySpecInputTags(const FGameplayAbilitySpec& AbilitySpec)
+{
+	if (FIndexedAbilitySpec* IndexedSpec = IndexedSpecs.Find(AbilitySpec.Handle))
+	{
+		UpdateIndexedInputTags(AbilitySpec, *IndexedSpec);
+	}
+}
+
+void UGASXAbilitySystemComponent::IndexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec, int32 Index)
+{
+	FIndexedAbilitySpec& IndexedSpec = IndexedSpecs.FindOrAdd(AbilitySpec.Handle);
+	IndexedSpec.Index = Index;
+	UpdateIndexedInputTags(AbilitySpec, IndexedSpec);
+}
+
+void UGASXAbilitySystemComponent::UnindexAbilitySpec(FGameplayAbilitySpecHandle Handle)
+{
+	FIndexedAbilitySpec IndexedSpec;
+	if (!IndexedSpecs.RemoveAndCopyValue(Handle, IndexedSpec))
+	{
+		return;
+	}
+
+	for (const FGameplayTag& Tag : IndexedSpec.InputTags)
+	{
+		RemoveInputTagSpecHandle(Tag, Handle);
+	}
+}
+
+void UGASXAbilitySystemComponent::RemoveInputTagSpecHandle(const FGameplayTag& InputTag, FGameplayAbilitySpecHandle Handle)
+{
+	if (auto* SpecHandles = InputTagToSpecHandles.Find(InputTag))
+	{
+		// Not swapped, so that lists keep the order in which specs were given.
+		SpecHandles->RemoveSingle(Handle);
+		if (SpecHandles->IsEmpty())
+		{
+			InputTagToSpecHandles.Remove(InputTag);
+		}
+	}
+}
+
+void UGASXAbilitySystemComponent::UpdateIndexedInputTags(const FGameplayAbilitySpec& AbilitySpec, FIndexedAbilitySpec& IndexedSpec)
+{
+	static const FGameplayTagContainer NoTags;
+	const FGameplayTagContainer& InputTags = AbilitySpec.Ability ? AbilitySpec.DynamicAbilityTags : NoTags;
+	if (InputTags == IndexedSpec.InputTags)
+	{
+		return;
+	}
+
+	for (const FGameplayTag& Tag : IndexedSpec.InputTags)
+	{
+		if (!InputTags.HasTagExact(Tag))
+		{
+			RemoveInputTagSpecHandle(Tag, AbilitySpec.Handle);
+		}
+	}
+	for (const FGameplayTag& Tag : InputTags)
+	{
+		if (!IndexedSpec.InputTags.HasTagExact(Tag))
+		{
+			InputTagToSpecHandles.FindOrAdd(Tag).Add(AbilitySpec.Handle);
+		}
+	}
+	IndexedSpec.InputTags = InputTags;
+}
+
 void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGamePaused)
 {
 	//if (HasMatchingGameplayTag(TAG_Gameplay_AbilityInputBlocked))
@@ -94,14 +199,12 @@ void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	static TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
 	AbilitiesToActivate.Reset();
 
-	//@TODO: See if we can use FScopedServerAbilityRPCBatcher ScopedRPCBatcher in some of these loops
-
 	//
 	// Process all abilities that activate when the input is held.
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputHeldSpecHandles)
 	{
-		if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandleIndexed(SpecHandle))
 		{
 			if (AbilitySpec->Ability && !AbilitySpec->IsActive())
 			{
@@ -120,26 +223,29 @@ void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputPressedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandleIndexed(SpecHandle))
 		{
 			if (AbilitySpec->Ability)
 			{
 				AbilitySpec->InputPressed = true;
 
+				const UGASXGameplayAbility* AbilityCDO = CastChecked<UGASXGameplayAbility>(AbilitySpec->Ability);
+
 				if (AbilitySpec->IsActive())
 				{
 					// Ability is active so pass along the input event.
 					AbilitySpecInputPressed(*AbilitySpec);
-				}
-				else
-				{
-					const UGASXGameplayAbility* AbilityCDO = CastChecked<UGASXGameplayAbility>(AbilitySpec->Ability);
 
-					if (AbilityCDO->GetActivationPolicy() == EGASXAbilityActivationPolicy::OnInputTriggered)
+					// Otherwise the press stays buffered and activates the ability again once it ends.
+					if (!AbilityCDO->ShouldBufferInputWhileActive())
 					{
-						AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
+						InputHandledSpecHandles.AddUnique(AbilitySpec->Handle);
 					}
 				}
+				else if (AbilityCDO->GetActivationPolicy() == EGASXAbilityActivationPolicy::OnInputTriggered)
+				{
+					AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
+				}
 			}
 		}
 	}
@@ -151,7 +257,10 @@ void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : AbilitiesToActivate)
 	{
-		TryActivateAbility(AbilitySpecHandle);
+		if (TryActivateAbilityBatched(AbilitySpecHandle))
+		{
+			InputHandledSpecHandles.AddUnique(AbilitySpecHandle);
+		}
 	}
 
 	//
@@ -159,7 +268,7 @@ void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputReleasedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandleIndexed(SpecHandle))
 		{
 			if (AbilitySpec->Ability)
 			{
@@ -174,11 +283,24 @@ void UGASXAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 		}
 	}
 
+	//
+	// Retry presses that failed to activate their ability this frame or earlier.
+	//
+	ReplayBufferedInput();
+
 	//
 	// Clear the cached ability handles.
 	//
 	InputPressedSpecHandles.Reset();
 	InputReleasedSpecHandles.Reset();
+	InputHandledSpecHandles.Reset();
+}
+
+bool UGASXAbilitySystemComponent::TryActivateAbilityBatched(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	// If the ability sends target data and ends within ActivateAbility(), all of it goes to the server in one RPC.
+	FScopedServerAbilityRPCBatcher ScopedRPCBatcher(this, AbilityHandle);
+	return TryActivateAbility(AbilityHandle);
 }
 
 void UGASXAbilitySystemComponent::ClearAbilityInput()
@@ -186,6 +308,180 @@ void UGASXAbilitySystemComponent::ClearAbilityInput()
 	InputPressedSpecHandles.Reset();
 	InputReleasedSpecHandles.Reset();
 	InputHeldSpecHandles.Reset();
+	InputHandledSpecHandles.Reset();
+
+	for (FBufferedInput& BufferedInput : InputBuffer)
+	{
+		BufferedInput.bConsumed = true;
+	}
+	NumPendingBufferedPresses = 0;
+}
+
+void UGASXAbilitySystemComponent::BufferInput(const FGameplayTag& InputTag, bool bPressed)
+{
+	const UWorld* World = GetWorld();
+	if (InputBufferWindow <= 0.f || !World)
+	{
+		return;
+	}
+
+	// Only the latest press of a tag is replayed.
+	if (bPressed)
+	{
+		for (FBufferedInput& BufferedInput : InputBuffer)
+		{
+			if (!BufferedInput.bConsumed && BufferedInput.InputTag == InputTag)
+			{
+				BufferedInput.bConsumed = true;
+				--NumPendingBufferedPresses;
+			}
+		}
+	}
+
+	FBufferedInput& NewInput = InputBuffer[InputBufferHead];
+	if (!NewInput.bConsumed)
+	{
+		--NumPendingBufferedPresses;
+	}
+	NewInput.InputTag = InputTag;
+	NewInput.Time = World->GetTimeSeconds();
+	NewInput.Frame = GFrameCounter;
+	NewInput.bPressed = bPressed;
+	NewInput.bConsumed = !bPressed;
+	NumPendingBufferedPresses += bPressed ? 1 : 0;
+	InputBufferHead = (InputBufferHead + 1) % InputBufferSize;
+}
+
+void UGASXAbilitySystemComponent::ReplayBufferedInput()
+{
+	const UWorld* World = GetWorld();
+	if (NumPendingBufferedPresses <= 0 || !World)
+	{
+		return;
+	}
+
+	const double Now = World->GetTimeSeconds();
+	for (int32 Offset = 0; Offset < InputBufferSize; ++Offset)
+	{
+		FBufferedInput& BufferedInput = InputBuffer[(InputBufferHead + Offset) % InputBufferSize];
+		if (BufferedInput.bConsumed)
+		{
+			continue;
+		}
+
+		bool bPending = false;
+		if (Now - BufferedInput.Time <= InputBufferWindow)
+		{
+			// The press was already tried this frame by ProcessAbilityInput(). Only keep it if it didn't get through.
+			const bool bPressedThisFrame = BufferedInput.Frame == GFrameCounter;
+
+			// Copied, as activation may give or remove abilities.
+			TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> SpecHandles;
+			if (const auto* IndexedSpecHandles = InputTagToSpecHandles.Find(BufferedInput.InputTag))
+			{
+				SpecHandles = *IndexedSpecHandles;
+			}
+
+			for (const FGameplayAbilitySpecHandle& SpecHandle : SpecHandles)
+			{
+				FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandleIndexed(SpecHandle);
+				const UGASXGameplayAbility* AbilityCDO = AbilitySpec ? Cast<UGASXGameplayAbility>(AbilitySpec->Ability) : nullptr;
+				if (!AbilityCDO || AbilityCDO->GetActivationPolicy() != EGASXAbilityActivationPolicy::OnInputTriggered)
+				{
+					continue;
+				}
+
+				// An instant ability activated by this press has already ended, so ask ProcessAbilityInput() instead of IsActive().
+				if (bPressedThisFrame)
+				{
+					bPending |= !InputHandledSpecHandles.Contains(SpecHandle);
+					continue;
+				}
+
+				if (AbilitySpec->IsActive())
+				{
+					// Wait for it to end, e.g. for the next attack of a combo.
+					bPending = true;
+					continue;
+				}
+
+				if (!TryActivateAbilityBatched(SpecHandle))
+				{
+					bPending = true;
+					continue;
+				}
+
+				// The input was let go while waiting.
+				for (int32 LaterOffset = Offset + 1; LaterOffset < InputBufferSize; ++LaterOffset)
+				{
+					const FBufferedInput& LaterInput = InputBuffer[(InputBufferHead + LaterOffset) % InputBufferSize];
+					if (!LaterInput.bPressed && LaterInput.InputTag == BufferedInput.InputTag && LaterInput.Time >= BufferedInput.Time)
+					{
+						if (FGameplayAbilitySpec* ActivatedSpec = FindAbilitySpecFromHandleIndexed(SpecHandle))
+						{
+							ActivatedSpec->InputPressed = false;
+							if (ActivatedSpec->IsActive())
+							{
+								AbilitySpecInputReleased(*ActivatedSpec);
+							}
+						}
+						break;
+					}
+				}
+			}
+		}
+
+		if (!bPending)
+		{
+			BufferedInput.bConsumed = true;
+			--NumPendingBufferedPresses;
+		}
+	}
+}
+
+void UGASXAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	++AbilitiesGeneration;
+
+	// Given specs are usually just added to the end.
+	int32 Index = ActivatableAbilities.Items.Num() - 1;
+	if (!ActivatableAbilities.Items.IsValidIndex(Index) || ActivatableAbilities.Items[Index].Handle != AbilitySpec.Handle)
+	{
+		Index = ActivatableAbilities.Items.IndexOfByPredicate([&AbilitySpec](const FGameplayAbilitySpec& Spec) { return Spec.Handle == AbilitySpec.Handle; });
+	}
+	IndexAbilitySpec(AbilitySpec, Index);
+}
+
+void UGASXAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+
+	++AbilitiesGeneration;
+	UnindexAbilitySpec(AbilitySpec.Handle);
+}
+
+void UGASXAbilitySystemComponent::OnOwnedOrBlockedTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	++OwnedTagsGeneration;
+}
+
+void UGASXAbilitySystemComponent::OnRep_ActivateAbilities()
+{
+	Super::OnRep_ActivateAbilities();
+
+	// Specs may have changed without being given or removed, e.g. their DynamicAbilityTags. Most changes are to other fields such as ActiveCount,
+	// so indices are refreshed and input tags compared, and only specs whose tags changed are moved between lists.
+	for (int32 Index = 0; Index < ActivatableAbilities.Items.Num(); ++Index)
+	{
+		const FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[Index];
+		if (FIndexedAbilitySpec* IndexedSpec = IndexedSpecs.Find(AbilitySpec.Handle))
+		{
+			IndexedSpec->Index = Index;
+			UpdateIndexedInputTags(AbilitySpec, *IndexedSpec);
+		}
+	}
 }
 
 void UGASXAbilitySystemComponent::AbilitySpecInputPressed(FGameplayAbilitySpec& Spec)
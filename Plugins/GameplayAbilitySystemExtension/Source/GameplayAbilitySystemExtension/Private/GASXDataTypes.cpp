@@ -15,6 +15,8 @@ bool FGASXGameplayEffectContainerSpec::HasValidTargets() const
 
 void FGASXGameplayEffectContainerSpec::AddTargets(const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors)
 {
+	TargetData.Data.Reserve(TargetData.Data.Num() + HitResults.Num() + (TargetActors.Num() > 0 ? 1 : 0));
+
 	for (const FHitResult& HitResult : HitResults)
 	{
 		FGameplayAbilityTargetData_SingleTargetHit* NewData = new FGameplayAbilityTargetData_SingleTargetHit(HitResult);
@@ -6,6 +6,7 @@
 #include "GASXTargetType.h"
 #include "AbilitySystemComponent.h"
 #include "Interfaces/GASXInteractable.h"
+#include "Interaction/GASXInteractableComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "Experience/GASXUserFacingExperienceDefinition.h"
 #include "Kismet/GameplayStatics.h"
@@ -16,6 +17,8 @@
 #include "GASXPawnComponent.h"
 #include "AIController.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Interface Calls"), STAT_GASXInteractionInterfaceCalls, STATGROUP_GASXInteraction);
+
 ////////////////////
 ///// UAbilitySystemComponent
 
@@ -44,10 +47,12 @@ FGameplayAbilitySpecHandle UGASXLibrary::GiveAbilityAndActivateOnceWithGameplayE
 ////////////////////
 ///// Target Type
 
-void UGASXLibrary::GetTargetTypeTargets(TSubclassOf<class UGASXTargetType> TargetType, FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors)
+void UGASXLibrary::GetTargetTypeTargets(TSubclassOf<class UGASXTargetType> TargetType, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors)
 {
-	const UGASXTargetType* TargetTypeCDO = TargetType.GetDefaultObject();
-	TargetTypeCDO->GetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+	if (const UGASXTargetType* TargetTypeCDO = TargetType.GetDefaultObject())
+	{
+		TargetTypeCDO->DispatchGetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+	}
 }
 
 ////////////////////
@@ -73,18 +78,65 @@ FActiveGameplayEffectHandle UGASXLibrary::ApplyAttributeSetInitializer(UAbilityS
 
 bool UGASXLibrary::IsTargetDataValidForInteraction(const FGameplayAbilityTargetDataHandle& InTargetData, TArray<AActor*> IgnoreActors, bool bChecksAvailability)
 {
-	if (UAbilitySystemBlueprintLibrary::TargetDataHasHitResult(InTargetData, 0))
+	const FGameplayAbilityTargetData* Data = InTargetData.Get(0);
+	const FHitResult* HitResult = Data ? Data->GetHitResult() : nullptr;
+	return HitResult != nullptr
+		&& !IgnoreActors.Contains(HitResult->GetActor())
+		&& IsHitResultValidForInteraction(*HitResult, nullptr, bChecksAvailability);
+}
+
+bool UGASXLibrary::IsHitResultValidForInteraction(const FHitResult& HitResult, const AActor* IgnoreActor, bool bChecksAvailability)
+{
+	AActor* HitActor = HitResult.GetActor();
+	if (HitActor == nullptr || HitActor == IgnoreActor || HitResult.GetComponent() == nullptr)
+	{
+		return false;
+	}
+
+	if (!HitActor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+	{
+		return false;
+	}
+	if (!bChecksAvailability)
+	{
+		return true;
+	}
+
+	// Fast path without reflection
+	if (const UGASXInteractableComponent* InteractableComponent = UGASXInteractableComponent::FindInteractableComponent(HitActor))
+	{
+		return InteractableComponent->IsAvailableForInteraction();
+	}
+	GASX_INTERACTION_COUNT(InterfaceCalls, 1);
+	return IGASXInteractable::Execute_IsAvailableForInteraction(HitActor, HitResult.GetComponent());
+}
+
+bool UGASXLibrary::IsAvailableForInteraction(AActor* InteractableActor, UPrimitiveComponent* InteractableComponent)
+{
+	if (!InteractableActor || !InteractableActor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+	{
+		return false;
+	}
+	if (const UGASXInteractableComponent* Interactable = UGASXInteractableComponent::FindInteractableComponent(InteractableActor))
+	{
+		return Interactable->IsAvailableForInteraction();
+	}
+	GASX_INTERACTION_COUNT(InterfaceCalls, 1);
+	return IGASXInteractable::Execute_IsAvailableForInteraction(InteractableActor, InteractableComponent);
+}
+
+float UGASXLibrary::GetInteractionDuration(AActor* InteractableActor, UPrimitiveComponent* InteractableComponent)
+{
+	if (!InteractableActor || !InteractableActor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+	{
+		return 0.f;
+	}
+	if (const UGASXInteractableComponent* Interactable = UGASXInteractableComponent::FindInteractableComponent(InteractableActor))
 	{
-		FHitResult HitResult = UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(InTargetData, 0);
-		AActor* HitActor = HitResult.GetActor();
-
-		return HitActor != nullptr
-			&& !IgnoreActors.Contains(HitActor)
-			&& HitResult.GetComponent() != nullptr
-			&& HitActor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass())
-			&& (!bChecksAvailability || IGASXInteractable::Execute_IsAvailableForInteraction(HitActor, HitResult.GetComponent()));
+		return Interactable->GetInteractionDuration();
 	}
-	return false;
+	GASX_INTERACTION_COUNT(InterfaceCalls, 1);
+	return IGASXInteractable::Execute_GetInteractionDuration(InteractableActor, InteractableComponent);
 }
 
 ////////////////////
@@ -4,3 +4,5 @@
 
 DEFINE_LOG_CATEGORY(LogGASX);
 DEFINE_LOG_CATEGORY(LogGASXExperience);
+
+CSV_DEFINE_CATEGORY_MODULE(GAMEPLAYABILITYSYSTEMEXTENSION_API, GASXInteraction, true);
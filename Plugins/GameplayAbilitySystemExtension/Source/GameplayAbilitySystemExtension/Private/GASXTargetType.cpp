@@ -2,17 +2,347 @@
 
 #include "GASXTargetType.h"
 #include "GameplayAbilities/GASXGameplayAbility.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "KismetTraceUtils.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "GASXMacroDefinitions.h"
+#include "DrawDebugHelpers.h"
+#include "Targeting/GASXHitboxComponent.h"
+#include "Targeting/GASXHitboxSubsystem.h"
+#include "Targeting/GASXLagCompensationSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Cache Hits"), STAT_GASXTargetCacheHits, STATGROUP_GASXTargeting);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Cache Misses"), STAT_GASXTargetCacheMisses, STATGROUP_GASXTargeting);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Cache Evictions"), STAT_GASXTargetCacheEvictions, STATGROUP_GASXTargeting);
+
+namespace GASXConsoleVariables
+{
+	static bool EnableTargetFrameCache = true;
+	static FAutoConsoleVariableRef CVarEnableTargetFrameCache(
+		TEXT("gasx.targeting.FrameCache"),
+		EnableTargetFrameCache,
+		TEXT("If true, UGASXTargetType::GetTargetsCached() reuses targets found earlier in the same frame."),
+		ECVF_Default);
+}
+
+namespace GASXTargetFrameCache
+{
+	// Everything of FGameplayEventData that targeting can read, compared by value. Target data and context are compared by identity.
+	struct FEventDataKey
+	{
+		FGameplayTag EventTag;
+		TObjectKey<AActor> Instigator;
+		TObjectKey<AActor> Target;
+		TObjectKey<UObject> OptionalObject;
+		TObjectKey<UObject> OptionalObject2;
+		const void* Context = nullptr;
+		float EventMagnitude = 0.f;
+		FGameplayTagContainer InstigatorTags;
+		FGameplayTagContainer TargetTags;
+		TArray<const void*, TInlineAllocator<2>> TargetData;
+
+		explicit FEventDataKey(const FGameplayEventData& EventData)
+			: EventTag(EventData.EventTag)
+			, Instigator(EventData.Instigator.Get())
+			, Target(EventData.Target.Get())
+			, OptionalObject(EventData.OptionalObject.Get())
+			, OptionalObject2(EventData.OptionalObject2.Get())
+			, Context(EventData.ContextHandle.Get())
+			, EventMagnitude(EventData.EventMagnitude)
+			, InstigatorTags(EventData.InstigatorTags)
+			, TargetTags(EventData.TargetTags)
+		{
+			for (int32 Index = 0; Index < EventData.TargetData.Num(); ++Index)
+			{
+				TargetData.Add(EventData.TargetData.Get(Index));
+			}
+		}
+
+		bool operator==(const FEventDataKey& Other) const
+		{
+			return EventTag == Other.EventTag && Instigator == Other.Instigator && Target == Other.Target
+				&& OptionalObject == Other.OptionalObject && OptionalObject2 == Other.OptionalObject2 && Context == Other.Context
+				&& EventMagnitude == Other.EventMagnitude && InstigatorTags == Other.InstigatorTags && TargetTags == Other.TargetTags
+				&& TargetData == Other.TargetData;
+		}
+
+		friend uint32 GetTypeHash(const FEventDataKey& Key)
+		{
+			uint32 Hash = GetTypeHash(Key.EventTag);
+			Hash = HashCombine(Hash, GetTypeHash(Key.Instigator));
+			Hash = HashCombine(Hash, GetTypeHash(Key.Target));
+			Hash = HashCombine(Hash, GetTypeHash(Key.OptionalObject));
+			Hash = HashCombine(Hash, GetTypeHash(Key.OptionalObject2));
+			Hash = HashCombine(Hash, PointerHash(Key.Context));
+			Hash = HashCombine(Hash, GetTypeHash(Key.EventMagnitude));
+			for (const FGameplayTag& Tag : Key.InstigatorTags)
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Tag));
+			}
+			for (const FGameplayTag& Tag : Key.TargetTags)
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Tag));
+			}
+			for (const void* Data : Key.TargetData)
+			{
+				Hash = HashCombine(Hash, PointerHash(Data));
+			}
+			return Hash;
+		}
+	};
+
+	struct FKey
+	{
+		TObjectKey<UClass> TargetTypeClass;
+		TObjectKey<AActor> AvatarActor;
+		FEventDataKey EventData;
+
+		bool operator==(const FKey& Other) const
+		{
+			return TargetTypeClass == Other.TargetTypeClass && AvatarActor == Other.AvatarActor && EventData == Other.EventData;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.TargetTypeClass), GetTypeHash(Key.AvatarActor)), GetTypeHash(Key.EventData));
+		}
+	};
+
+	struct FEntry
+	{
+		TArray<FHitResult> HitResults;
+		// Weak in case actors are destroyed later in the frame
+		TArray<TWeakObjectPtr<AActor>> Actors;
+	};
+
+	// Only touched on the game thread. Everything is evicted when a new frame starts.
+	static TMap<FKey, FEntry> Entries;
+	static uint64 FrameNumber = 0;
+
+	static void EvictIfNewFrame()
+	{
+		if (FrameNumber != GFrameCounter)
+		{
+			INC_DWORD_STAT_BY(STAT_GASXTargetCacheEvictions, Entries.Num());
+			Entries.Reset();
+			FrameNumber = GFrameCounter;
+		}
+	}
+}
+
+namespace GASXTargetTypeHelpers
+{
+	static FTransform GetSceneObjectTransform(ESceneObjectType SceneObjectType, const FGameplayAbilityActorInfo& ActorInfo)
+	{
+		switch (SceneObjectType)
+		{
+		case ESceneObjectType::SOT_OwnerActor:
+			if (ActorInfo.OwnerActor.IsValid()) return ActorInfo.OwnerActor->GetActorTransform();
+			break;
+		case ESceneObjectType::SOT_AvatarActor:
+			if (ActorInfo.AvatarActor.IsValid()) return ActorInfo.AvatarActor->GetActorTransform();
+			break;
+		case ESceneObjectType::SOT_SkeletalMeshComponent:
+			if (ActorInfo.SkeletalMeshComponent.IsValid()) return ActorInfo.SkeletalMeshComponent->GetComponentTransform();
+			break;
+		case ESceneObjectType::SOT_None:
+		default:
+			break;
+		}
+		return FTransform();
+	}
+
+	/**
+	 * Filters candidate positions 4 at a time. Positions are relative to the origin and stored as separate X/Y/Z arrays padded to a multiple of 4.
+	 * Indices of passing candidates are appended to OutPassingIndices in ascending order.
+	 */
+	template<typename AllocatorType>
+	static void FilterCandidatePositions(const FGASXCandidateFilter& Filter, const FVector3f& Forward, const FVector3f& Up, const float* X, const float* Y, const float* Z, int32 Num, TArray<int32, AllocatorType>& OutPassingIndices)
+	{
+		const VectorRegister4Float MaxDistanceSquared = VectorSetFloat1(Filter.MaxDistanceSquared);
+		const VectorRegister4Float MinHeight = VectorSetFloat1(Filter.MinHeight);
+		const VectorRegister4Float MaxHeight = VectorSetFloat1(Filter.MaxHeight);
+		const VectorRegister4Float CosHalfAngle = VectorSetFloat1(Filter.CosHalfAngle);
+		const VectorRegister4Float ForwardX = VectorSetFloat1(Forward.X);
+		const VectorRegister4Float ForwardY = VectorSetFloat1(Forward.Y);
+		const VectorRegister4Float ForwardZ = VectorSetFloat1(Forward.Z);
+		const VectorRegister4Float UpX = VectorSetFloat1(Up.X);
+		const VectorRegister4Float UpY = VectorSetFloat1(Up.Y);
+		const VectorRegister4Float UpZ = VectorSetFloat1(Up.Z);
+
+		for (int32 Index = 0; Index < Num; Index += 4)
+		{
+			const VectorRegister4Float PX = VectorLoad(X + Index);
+			const VectorRegister4Float PY = VectorLoad(Y + Index);
+			const VectorRegister4Float PZ = VectorLoad(Z + Index);
+
+			const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(PX, PX, VectorMultiplyAdd(PY, PY, VectorMultiply(PZ, PZ)));
+			const VectorRegister4Float Height = VectorMultiplyAdd(PX, UpX, VectorMultiplyAdd(PY, UpY, VectorMultiply(PZ, UpZ)));
+			const VectorRegister4Float AlongForward = VectorMultiplyAdd(PX, ForwardX, VectorMultiplyAdd(PY, ForwardY, VectorMultiply(PZ, ForwardZ)));
+
+			VectorRegister4Float Mask = VectorCompareLE(DistanceSquared, MaxDistanceSquared);
+			Mask = VectorBitwiseAnd(Mask, VectorCompareGE(Height, MinHeight));
+			Mask = VectorBitwiseAnd(Mask, VectorCompareLE(Height, MaxHeight));
+			// cos(angle) >= CosHalfAngle without normalizing: dot(P, Forward) >= CosHalfAngle * |P|
+			Mask = VectorBitwiseAnd(Mask, VectorCompareGE(AlongForward, VectorMultiply(CosHalfAngle, VectorSqrt(DistanceSquared))));
+
+			uint32 Bits = (uint32)VectorMaskBits(Mask);
+			while (Bits != 0)
+			{
+				const int32 CandidateIndex = Index + (int32)FMath::CountTrailingZeros(Bits);
+				if (CandidateIndex < Num) OutPassingIndices.Add(CandidateIndex);
+				Bits &= Bits - 1;
+			}
+		}
+	}
+}
 
 ////////////////////
 ///// UGASXTargetType
 
-UObject* UGASXTargetType::GetWorldContextObjectFromActorInfo(FGameplayAbilityActorInfo ActorInfo) const
+void UGASXTargetType::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	CacheBlueprintOverrides();
+	CompileFilter();
+}
+
+void UGASXTargetType::PostLoad()
+{
+	Super::PostLoad();
+
+	CacheBlueprintOverrides();
+	CompileFilter();
+}
+
+#if WITH_EDITOR
+void UGASXTargetType::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	CompileFilter();
+}
+#endif
+
+void UGASXTargetType::CompileFilter()
+{
+	CompiledFilter.Compile(Filter);
+}
+
+void UGASXTargetType::CacheBlueprintOverrides()
+{
+	const UClass* Class = GetClass();
+	bBlueprintGetFilterActor = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType, GetFilterActor));
+	bBlueprintMakeFilterHandle = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType, MakeFilterHandle));
+	bBlueprintFilterTargets = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType, FilterTargets));
+	bBlueprintGetTargets = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType, GetTargets));
+}
+
+UObject* UGASXTargetType::GetWorldContextObjectFromActorInfo(const FGameplayAbilityActorInfo& ActorInfo) const
 {
 	check(ActorInfo.OwnerActor.IsValid());
 	return ActorInfo.OwnerActor->GetWorld();
 }
 
+AActor* UGASXTargetType::DispatchGetFilterActor(const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	return bBlueprintGetFilterActor ? GetFilterActor(ActorInfo) : NativeGetFilterActor(ActorInfo);
+}
+
+FGameplayTargetDataFilterHandle UGASXTargetType::DispatchMakeFilterHandle(const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	return bBlueprintMakeFilterHandle ? MakeFilterHandle(ActorInfo) : NativeMakeFilterHandle(ActorInfo);
+}
+
+void UGASXTargetType::DispatchFilterTargets(const FGameplayAbilityActorInfo& ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const
+{
+	if (bBlueprintFilterTargets)
+	{
+		FilterTargets(ActorInfo, InOutHitResults, InOutActors);
+	}
+	else
+	{
+		NativeFilterTargets(ActorInfo, InOutHitResults, InOutActors);
+	}
+}
+
+void UGASXTargetType::DispatchGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	if (bBlueprintGetTargets)
+	{
+		GetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+	}
+	else
+	{
+		NativeGetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+	}
+}
+
+void UGASXTargetType::GetTargetsCached(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	if (!bAllowFrameCache || !GASXConsoleVariables::EnableTargetFrameCache || !IsInGameThread())
+	{
+		DispatchGetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+		return;
+	}
+
+	using namespace GASXTargetFrameCache;
+	EvictIfNewFrame();
+
+	FKey Key{ GetClass(), ActorInfo.AvatarActor.Get(), FEventDataKey(EventData) };
+	if (const FEntry* FoundEntry = Entries.Find(Key))
+	{
+		INC_DWORD_STAT(STAT_GASXTargetCacheHits);
+
+		OutHitResults.Append(FoundEntry->HitResults);
+		OutActors.Reserve(OutActors.Num() + FoundEntry->Actors.Num());
+		for (const TWeakObjectPtr<AActor>& WeakActor : FoundEntry->Actors)
+		{
+			if (AActor* Actor = WeakActor.Get()) OutActors.Add(Actor);
+		}
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GASXTargetCacheMisses);
+
+	// Resolve into fresh arrays so that anything already in the out params doesn't end up in the cache.
+	TArray<FHitResult> HitResults;
+	TArray<AActor*> Actors;
+	DispatchGetTargets(ActorInfo, EventData, HitResults, Actors);
+
+	FEntry& NewEntry = Entries.Add(MoveTemp(Key));
+	NewEntry.HitResults = HitResults;
+	NewEntry.Actors.Append(Actors);
+
+	OutHitResults.Append(MoveTemp(HitResults));
+	OutActors.Append(MoveTemp(Actors));
+}
+
 AActor* UGASXTargetType::GetFilterActor_Implementation(FGameplayAbilityActorInfo ActorInfo) const
+{
+	return NativeGetFilterActor(ActorInfo);
+}
+
+FGameplayTargetDataFilterHandle UGASXTargetType::MakeFilterHandle_Implementation(FGameplayAbilityActorInfo ActorInfo) const
+{
+	return NativeMakeFilterHandle(ActorInfo);
+}
+
+void UGASXTargetType::FilterTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const
+{
+	NativeFilterTargets(ActorInfo, InOutHitResults, InOutActors);
+}
+
+void UGASXTargetType::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	NativeGetTargets(ActorInfo, EventData, OutHitResults, OutActors);
+}
+
+AActor* UGASXTargetType::NativeGetFilterActor(const FGameplayAbilityActorInfo& ActorInfo) const
 {
 	switch (FilterActorType)
 	{
@@ -26,64 +356,108 @@ AActor* UGASXTargetType::GetFilterActor_Implementation(FGameplayAbilityActorInfo
 	}
 }
 
-FGameplayTargetDataFilterHandle UGASXTargetType::MakeFilterHandle_Implementation(FGameplayAbilityActorInfo ActorInfo) const
+FGameplayTargetDataFilterHandle UGASXTargetType::NativeMakeFilterHandle(const FGameplayAbilityActorInfo& ActorInfo) const
 {
 	FGameplayTargetDataFilterHandle FilterHandle;
 	FGameplayTargetDataFilter* NewFilter = new FGameplayTargetDataFilter(Filter);
-	NewFilter->InitializeFilterContext(GetFilterActor(ActorInfo));
+	NewFilter->InitializeFilterContext(DispatchGetFilterActor(ActorInfo));
 	FilterHandle.Filter = TSharedPtr<FGameplayTargetDataFilter>(NewFilter);
 	return FilterHandle;
 }
 
-void UGASXTargetType::FilterTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const
+void UGASXTargetType::NativeFilterTargets(const FGameplayAbilityActorInfo& ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const
 {
-	FGameplayTargetDataFilterHandle FilterHandle = MakeFilterHandle(ActorInfo);
+	if (bBlueprintMakeFilterHandle)
+	{
+		// The filter handle is made in Blueprint, so the compiled filter can't be used.
+		FGameplayTargetDataFilterHandle FilterHandle = MakeFilterHandle(ActorInfo);
+
+		InOutActors.RemoveAll([&FilterHandle](const AActor* Actor) {
+			return !FilterHandle.FilterPassesForActor(Actor);
+			});
+
+		if (bFilterHitResults)
+		{
+			InOutHitResults.RemoveAll([&FilterHandle](const FHitResult& HitResult) {
+				if (AActor* HitActor = HitResult.GetActor())
+				{
+					return !FilterHandle.FilterPassesForActor(HitActor);
+				}
+				return true; // removes if the actor is invalid
+				});
+		}
+		return;
+	}
 
-	InOutActors.RemoveAll([&FilterHandle](const AActor* Actor) {
-		return !FilterHandle.FilterPassesForActor(Actor);
+	const AActor* SelfActor = DispatchGetFilterActor(ActorInfo);
+
+	// Single pass that keeps the order of targets, which may already be ranked by priority.
+	InOutActors.RemoveAll([this, SelfActor](const AActor* Actor) {
+		return !CompiledFilter.PassesForActor(Actor, SelfActor);
 		});
 
 	if (bFilterHitResults)
 	{
-		InOutHitResults.RemoveAll([&FilterHandle](const FHitResult& HitResult) {
-			if (AActor* HitActor = HitResult.GetActor())
-			{
-				return !FilterHandle.FilterPassesForActor(HitActor);
-			}
-			return true; // removes if the actor is invalid
+		// Also removes hits without a valid actor
+		InOutHitResults.RemoveAll([this, SelfActor](const FHitResult& HitResult) {
+			return !CompiledFilter.PassesForActor(HitResult.GetActor(), SelfActor);
 			});
 	}
 }
 
-void UGASXTargetType::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGASXTargetType::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
 	return;
 }
 
+FTraceHandle UGASXTargetType::GetTargetsAsync(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXTargetsReadyDelegate OnTargetsReady) const
+{
+	TArray<FHitResult> HitResults;
+	TArray<AActor*> Actors;
+	DispatchGetTargets(ActorInfo, EventData, HitResults, Actors);
+
+	if (UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo)))
+	{
+		// Actors may be destroyed before next tick, so don't hold raw pointers until then.
+		TArray<TWeakObjectPtr<AActor>> WeakActors(Actors);
+		World->GetTimerManager().SetTimerForNextTick([OnTargetsReady, HitResults = MoveTemp(HitResults), WeakActors = MoveTemp(WeakActors)]()
+			{
+				TArray<AActor*> ValidActors;
+				ValidActors.Reserve(WeakActors.Num());
+				for (const TWeakObjectPtr<AActor>& WeakActor : WeakActors)
+				{
+					if (AActor* Actor = WeakActor.Get()) ValidActors.Add(Actor);
+				}
+				OnTargetsReady.ExecuteIfBound(HitResults, ValidActors);
+			});
+	}
+	return FTraceHandle();
+}
+
 ////////////////////
 ///// UGASXTargetType_UseOwner
 
-void UGASXTargetType_UseOwner::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGASXTargetType_UseOwner::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
 	if (ActorInfo.OwnerActor.IsValid()) OutActors.Add(ActorInfo.OwnerActor.Get());
 
-	FilterTargets(ActorInfo, OutHitResults, OutActors);
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
 }
 
 ////////////////////
 ///// UGASXTargetType_UseAvatar
 
-void UGASXTargetType_UseAvatar::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGASXTargetType_UseAvatar::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
 	if (ActorInfo.AvatarActor.IsValid()) OutActors.Add(ActorInfo.AvatarActor.Get());
 
-	FilterTargets(ActorInfo, OutHitResults, OutActors);
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
 }
 
 ////////////////////
 ///// UGASXTargetType_UseEventData
 
-void UGASXTargetType_UseEventData::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGASXTargetType_UseEventData::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
 	const FHitResult* FoundHitResult = EventData.ContextHandle.GetHitResult();
 	if (FoundHitResult)
@@ -95,13 +469,13 @@ void UGASXTargetType_UseEventData::GetTargets_Implementation(FGameplayAbilityAct
 		OutActors.Add(const_cast<AActor*>(EventData.Target.Get()));
 	}
 
-	FilterTargets(ActorInfo, OutHitResults, OutActors);
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
 }
 
 ////////////////////
 ///// UGASXTargetType_TraceBase
 
-UObject* UGASXTargetType_TraceBase::GetSceneObject(FGameplayAbilityActorInfo ActorInfo) const
+UObject* UGASXTargetType_TraceBase::GetSceneObject(const FGameplayAbilityActorInfo& ActorInfo) const
 {
 	switch (SceneObjectType)
 	{
@@ -121,577 +495,938 @@ UObject* UGASXTargetType_TraceBase::GetSceneObject(FGameplayAbilityActorInfo Act
 	return nullptr;
 }
 
-FTransform UGASXTargetType_TraceBase::GetSceneObjectTransform(FGameplayAbilityActorInfo ActorInfo) const
+FTransform UGASXTargetType_TraceBase::GetSceneObjectTransform(const FGameplayAbilityActorInfo& ActorInfo) const
 {
-	switch (SceneObjectType)
+	return GASXTargetTypeHelpers::GetSceneObjectTransform(SceneObjectType, ActorInfo);
+}
+
+void UGASXTargetType_TraceBase::CacheBlueprintOverrides()
+{
+	Super::CacheBlueprintOverrides();
+
+	const UClass* Class = GetClass();
+	bBlueprintGetTraceStartAndEnd = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType_TraceBase, GetTraceStartAndEnd));
+	bBlueprintGetActorsToIgnore = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGASXTargetType_TraceBase, GetActorsToIgnore));
+}
+
+void UGASXTargetType_TraceBase::DispatchGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const
+{
+	if (bBlueprintGetTraceStartAndEnd)
 	{
-	case ESceneObjectType::SOT_OwnerActor:
-		if (ActorInfo.OwnerActor.IsValid()) return ActorInfo.OwnerActor->GetActorTransform();
-		break;
-	case ESceneObjectType::SOT_AvatarActor:
-		if (ActorInfo.AvatarActor.IsValid()) return ActorInfo.AvatarActor->GetActorTransform();
-		break;
-	case ESceneObjectType::SOT_SkeletalMeshComponent:
-		if (ActorInfo.SkeletalMeshComponent.IsValid()) return ActorInfo.SkeletalMeshComponent->GetComponentTransform();
-		break;
-	case ESceneObjectType::SOT_None:
-	default:
-		break;
+		GetTraceStartAndEnd(ActorInfo, EventData, OutStart, OutEnd);
+	}
+	else
+	{
+		NativeGetTraceStartAndEnd(ActorInfo, EventData, OutStart, OutEnd);
+	}
+}
+
+void UGASXTargetType_TraceBase::DispatchGetActorsToIgnore(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXActorsToIgnoreArray& OutActors) const
+{
+	if (bBlueprintGetActorsToIgnore)
+	{
+		OutActors.Append(GetActorsToIgnore(ActorInfo, EventData));
+	}
+	else
+	{
+		NativeGetActorsToIgnore(ActorInfo, EventData, OutActors);
 	}
-	return FTransform();
 }
 
 void UGASXTargetType_TraceBase::GetTraceStartAndEnd_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, FVector& OutStart, FVector& OutEnd) const
 {
-	return;
+	NativeGetTraceStartAndEnd(ActorInfo, EventData, OutStart, OutEnd);
 }
 
 TArray<AActor*> UGASXTargetType_TraceBase::GetActorsToIgnore_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData) const
 {
-	TArray<AActor*> Actors;
-	if (ActorInfo.AvatarActor.IsValid()) Actors.Add(ActorInfo.AvatarActor.Get());
-	return Actors;
+	FGASXActorsToIgnoreArray Actors;
+	NativeGetActorsToIgnore(ActorInfo, EventData, Actors);
+	return TArray<AActor*>(Actors);
 }
 
-void UGASXTargetType_TraceBase::GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGASXTargetType_TraceBase::NativeGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const
 {
-	FVector Start, End;
-	GetTraceStartAndEnd(ActorInfo, EventData, Start, End);
+	return;
+}
+
+void UGASXTargetType_TraceBase::NativeGetActorsToIgnore(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXActorsToIgnoreArray& OutActors) const
+{
+	if (ActorInfo.AvatarActor.IsValid()) OutActors.Add(ActorInfo.AvatarActor.Get());
+}
 
-	TArray<AActor*> ActorsToIgnore = GetActorsToIgnore(ActorInfo, EventData);
+float UGASXTargetType_TraceBase::ScoreHit(const FGameplayAbilityActorInfo& ActorInfo, const FHitResult& Hit, const FVector& TraceStart, const FVector& TraceDirection) const
+{
+	const AActor* HitActor = Hit.GetActor();
+	const FVector TargetLocation = HitActor ? HitActor->GetActorLocation() : Hit.ImpactPoint;
 
-	if (UObject* WorldContextObject = GetWorldContextObjectFromActorInfo(ActorInfo))
+	switch (TargetPriority)
 	{
-		bool bHit = false;
+	case EGASXTargetPriority::TP_Distance:
+		return -FVector::DistSquared(TraceStart, TargetLocation);
+	case EGASXTargetPriority::TP_AngleToForward:
+		return FVector::DotProduct(TraceDirection, (TargetLocation - TraceStart).GetSafeNormal());
+	case EGASXTargetPriority::TP_Custom:
+		return ScoreHitCustom(ActorInfo, Hit, TraceStart, TraceDirection);
+	case EGASXTargetPriority::TP_None:
+	default:
+		return 0.f;
+	}
+}
+
+void UGASXTargetType_TraceBase::SelectTargets(const FGameplayAbilityActorInfo& ActorInfo, const FVector& Start, const FVector& End, bool bActorsAsTargets, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& OutActors) const
+{
+	using FUniqueActorSet = TSet<AActor*, DefaultKeyFuncs<AActor*>, TInlineSetAllocator<32>>;
 
-		if (TraceShapeType == EGASXTraceShapeType::TST_LineTrace)
+	const int32 NumHits = InOutHitResults.Num();
+
+	// Hits that filtering will remove must not use up the budget. If the filter is compiled, they are skipped here.
+	// Otherwise everything is kept in order and TrimToMaxTargets() cuts off the rest after filtering.
+	const bool bFiltered = bActorsAsTargets || bFilterHitResults;
+	const bool bPreFilter = bFiltered && IsFilterCompiled();
+	const int32 Budget = MaxTargets > 0 && (bPreFilter || !bFiltered) ? MaxTargets : MAX_int32;
+	const AActor* SelfActor = bPreFilter ? DispatchGetFilterActor(ActorInfo) : nullptr;
+	const auto PassesFilter = [this, bPreFilter, SelfActor](const FHitResult& Hit) { return !bPreFilter || CompiledFilter.PassesForActor(Hit.GetActor(), SelfActor); };
+
+	if (TargetPriority == EGASXTargetPriority::TP_None || NumHits <= 1)
+	{
+		// Keep trace order and just cut off the rest.
+		if (bActorsAsTargets)
 		{
-			if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
+			FUniqueActorSet UniqueActors;
+			for (const FHitResult& Hit : InOutHitResults)
 			{
-				FHitResult SingleHitResult;
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::LineTraceSingle(
-						WorldContextObject,
-						Start,
-						End,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::LineTraceSingleByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::LineTraceSingleForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
+				if (UniqueActors.Num() >= Budget) break;
+				if (!PassesFilter(Hit)) continue;
 
-				if (bHit) OutHitResults.Add(SingleHitResult);
-			}
-			else if (TraceHitType == EGASXTraceHitType::THT_MultiTrace)
-			{
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::LineTraceMulti(
-						WorldContextObject,
-						Start,
-						End,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::LineTraceMultiByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::LineTraceMultiForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
+				bool bAlreadyInSet = false;
+				UniqueActors.Add(Hit.GetActor(), &bAlreadyInSet);
+				if (!bAlreadyInSet) OutActors.Add(Hit.GetActor());
 			}
+			InOutHitResults.Empty();
 		}
-		else if (TraceShapeType == EGASXTraceShapeType::TST_SphereTrace)
+		else if (Budget < NumHits)
 		{
-
-			if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
-			{
-				FHitResult SingleHitResult;
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::SphereTraceSingle(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::SphereTraceSingleByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::SphereTraceSingleForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
-
-				if (bHit) OutHitResults.Add(SingleHitResult);
-			}
-			else if (TraceHitType == EGASXTraceHitType::THT_MultiTrace)
+			int32 NumSelected = 0;
+			for (int32 Index = 0; Index < NumHits && NumSelected < Budget; ++Index)
 			{
-				switch (TraceTargetType)
+				if (PassesFilter(InOutHitResults[Index]))
 				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::SphereTraceMulti(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::SphereTraceMultiByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::SphereTraceMultiForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
+					if (NumSelected != Index) InOutHitResults[NumSelected] = MoveTemp(InOutHitResults[Index]);
+					++NumSelected;
 				}
 			}
+			InOutHitResults.SetNum(NumSelected, EAllowShrinking::No);
 		}
-		else if (TraceShapeType == EGASXTraceShapeType::TST_CapsuleTrace)
-		{
+		return;
+	}
 
-			if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
-			{
-				FHitResult SingleHitResult;
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::CapsuleTraceSingle(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::CapsuleTraceSingleByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::CapsuleTraceSingleForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
+	// Score every hit once, then pop the best ones off a heap. Only as many hits as we keep get sorted.
+	struct FScoredHit
+	{
+		float Score;
+		int32 Index;
+	};
+	const auto HigherScoreFirst = [](const FScoredHit& A, const FScoredHit& B) { return A.Score > B.Score; };
 
-				if (bHit) OutHitResults.Add(SingleHitResult);
-			}
-			else if (TraceHitType == EGASXTraceHitType::THT_MultiTrace)
-			{
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::CapsuleTraceMulti(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::CapsuleTraceMultiByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::CapsuleTraceMultiForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						TraceRadius,
-						CapsuleTraceHalfHeight,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
-			}
-		}
-		else if (TraceShapeType == EGASXTraceShapeType::TST_BoxTrace)
+	const FVector Direction = (End - Start).GetSafeNormal();
+	TArray<FScoredHit, TInlineAllocator<32>> Heap;
+	Heap.Reserve(NumHits);
+	for (int32 Index = 0; Index < NumHits; ++Index)
+	{
+		if (PassesFilter(InOutHitResults[Index]))
 		{
+			Heap.Add({ ScoreHit(ActorInfo, InOutHitResults[Index], Start, Direction), Index });
+		}
+	}
+	Heap.Heapify(HigherScoreFirst);
 
-			if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
-			{
-				FHitResult SingleHitResult;
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::BoxTraceSingle(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::BoxTraceSingleByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::BoxTraceSingleForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						SingleHitResult,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
+	FUniqueActorSet UniqueActors;
+	TArray<FHitResult> SelectedHits;
+	if (!bActorsAsTargets) SelectedHits.Reserve(FMath::Min(Heap.Num(), Budget));
 
-				if (bHit) OutHitResults.Add(SingleHitResult);
-			}
-			else if (TraceHitType == EGASXTraceHitType::THT_MultiTrace)
-			{
-				switch (TraceTargetType)
-				{
-				case EGASXTraceTargetType::TTT_ByChannel:
-					bHit = UKismetSystemLibrary::BoxTraceMulti(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						TraceChannel,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByProfile:
-					bHit = UKismetSystemLibrary::BoxTraceMultiByProfile(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						ProfileName.Name,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				case EGASXTraceTargetType::TTT_ByObjectTypes:
-					bHit = UKismetSystemLibrary::BoxTraceMultiForObjects(
-						WorldContextObject,
-						Start,
-						End,
-						BoxTraceHalfSize,
-						BoxTraceOrientation,
-						ObjectTypes,
-						bTraceComplex,
-						ActorsToIgnore,
-						DrawDebugType,
-						OutHitResults,
-						true,
-						DebugTraceColor,
-						DebugTraceHitColor,
-						DebugDrawTime
-					);
-					break;
-				default:
-					break;
-				}
-			}
-		}
+	int32 NumSelected = 0;
+	while (Heap.Num() > 0 && NumSelected < Budget)
+	{
+		FScoredHit Best;
+		Heap.HeapPop(Best, HigherScoreFirst, EAllowShrinking::No);
 
-		if (bHit && bHitActorsAsTargets)
+		FHitResult& Hit = InOutHitResults[Best.Index];
+		if (bActorsAsTargets)
 		{
-			for (const auto& Hit : OutHitResults)
-			{
-				// no duplicates
-				OutActors.AddUnique(Hit.GetActor());
-			}
-			OutHitResults.Empty();
+			bool bAlreadyInSet = false;
+			UniqueActors.Add(Hit.GetActor(), &bAlreadyInSet);
+			if (bAlreadyInSet) continue;
+
+			OutActors.Add(Hit.GetActor());
+		}
+		else
+		{
+			SelectedHits.Add(MoveTemp(Hit));
 		}
+		++NumSelected;
 	}
 
-	FilterTargets(ActorInfo, OutHitResults, OutActors);
+	if (bActorsAsTargets)
+	{
+		InOutHitResults.Empty();
+	}
+	else
+	{
+		InOutHitResults = MoveTemp(SelectedHits);
+	}
 }
 
-////////////////////
-///// UGASXTargetType_TraceFromAvatarActor
-
-void UGASXTargetType_TraceFromAvatarActor::GetTraceStartAndEnd_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, FVector& OutStart, FVector& OutEnd) const
+void UGASXTargetType_TraceBase::TrimToMaxTargets(bool bActorsAsTargets, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const
 {
-	FTransform BaseTransform = GetSceneObjectTransform(ActorInfo);
-	FVector BaseForward = BaseTransform.GetUnitAxis(EAxis::X);
+	if (MaxTargets <= 0)
+	{
+		return;
+	}
 
-	OutStart = BaseTransform.TransformPosition(OffsetFromActor);
-	OutEnd = BaseTransform.GetLocation() + BaseForward * TraceLength;
+	// Filtering keeps the order, so the best targets are first.
+	if (bActorsAsTargets)
+	{
+		if (InOutActors.Num() > MaxTargets) InOutActors.SetNum(MaxTargets, EAllowShrinking::No);
+	}
+	else if (InOutHitResults.Num() > MaxTargets)
+	{
+		InOutHitResults.SetNum(MaxTargets, EAllowShrinking::No);
+	}
+}
+
+void UGASXTargetType_TraceBase::MakeQueryParams(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FCollisionQueryParams& OutQueryParams) const
+{
+	FGASXActorsToIgnoreArray ActorsToIgnore;
+	DispatchGetActorsToIgnore(ActorInfo, EventData, ActorsToIgnore);
+
+	// Copying the cached params is cheap because ignored actors/components use inline allocators.
+	OutQueryParams = CollisionQuery.QueryParams;
+	for (AActor* Actor : ActorsToIgnore)
+	{
+		OutQueryParams.AddIgnoredActor(Actor);
+	}
+}
+
+void UGASXTargetType_TraceBase::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	FVector Start, End;
+	DispatchGetTraceStartAndEnd(ActorInfo, EventData, Start, End);
+
+	bool bActorsAsTargets = false;
+	if (const UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo)))
+	{
+		FCollisionQueryParams QueryParams;
+		MakeQueryParams(ActorInfo, EventData, QueryParams);
+
+		bool bHit = PerformTrace(World, Start, End, QueryParams, OutHitResults);
+		if (ShouldLagCompensate(ActorInfo))
+		{
+			bHit = ApplyLagCompensation(ActorInfo, EventData, World, Start, End, QueryParams, OutHitResults);
+		}
+
+		bActorsAsTargets = bHit && bHitActorsAsTargets;
+		SelectTargets(ActorInfo, Start, End, bActorsAsTargets, OutHitResults, OutActors);
+	}
+
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
+	TrimToMaxTargets(bActorsAsTargets, OutHitResults, OutActors);
+}
+
+bool UGASXTargetType_TraceBase::IsRemotePlayer(const FGameplayAbilityActorInfo& ActorInfo)
+{
+	// The listen server host and AI see the world as it is on the server, so there is nothing to rewind for them.
+	const APlayerController* PC = ActorInfo.PlayerController.Get();
+	return PC && !ActorInfo.IsLocallyControlled() && PC->GetNetConnection() && PC->PlayerState;
+}
+
+bool UGASXTargetType_TraceBase::ShouldLagCompensate(const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	return bLagCompensate && ActorInfo.IsNetAuthority() && IsRemotePlayer(ActorInfo);
+}
+
+double UGASXTargetType_TraceBase::GetRewindTimestamp(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData) const
+{
+	const UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo));
+	if (!World)
+	{
+		return 0.0;
+	}
+
+	if (!IsRemotePlayer(ActorInfo))
+	{
+		return World->GetTimeSeconds();
+	}
+
+	// Ping is the round trip time in milliseconds
+	const float OneWayLatency = ActorInfo.PlayerController->PlayerState->GetPingInMilliseconds() * 0.0005f;
+	const float RewindTime = FMath::Min(OneWayLatency + RewindInterpolationDelay, MaxRewindTime);
+	return World->GetTimeSeconds() - RewindTime;
+}
+
+bool UGASXTargetType_TraceBase::ApplyLagCompensation(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, TArray<FHitResult>& InOutHitResults) const
+{
+	const UGASXLagCompensationSubsystem* LagCompensation = UWorld::GetSubsystem<UGASXLagCompensationSubsystem>(World);
+	if (!LagCompensation)
+	{
+		return InOutHitResults.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	}
+
+	// Tracked actors are only hit where they were, so physics hits on them are dropped.
+	const bool bBlockedByTrackedActor = InOutHitResults.Num() > 0 && InOutHitResults.Last().bBlockingHit && LagCompensation->IsActorTracked(InOutHitResults.Last().GetActor());
+	InOutHitResults.RemoveAll([LagCompensation](const FHitResult& Hit) { return LagCompensation->IsActorTracked(Hit.GetActor()); });
+
+	// Rewound capsules behind level geometry must not be hit. If a tracked actor blocked the trace, what is behind it is unknown, so trace again without tracked actors.
+	if (bBlockedByTrackedActor)
+	{
+		FCollisionQueryParams OcclusionQueryParams = QueryParams;
+		FHitResult OcclusionHit;
+		for (int32 Attempt = 0; Attempt < MaxOcclusionTraces && PerformSingleTrace(World, Start, End, OcclusionQueryParams, OcclusionHit); ++Attempt)
+		{
+			AActor* HitActor = OcclusionHit.GetActor();
+			if (!LagCompensation->IsActorTracked(HitActor))
+			{
+				InOutHitResults.Add(OcclusionHit);
+				break;
+			}
+			OcclusionQueryParams.AddIgnoredActor(HitActor);
+		}
+	}
+
+	float QueryRadius = 0.f;
+	if (!CollisionQuery.bIsLineTrace)
+	{
+		QueryRadius = CollisionQuery.Shape.IsBox() ? (float)CollisionQuery.Shape.GetExtent().GetMax() : CollisionQuery.Shape.GetCapsuleRadius();
+	}
+
+	TArray<FGASXRewoundHit> RewoundHits;
+	LagCompensation->SweepSphereAtTime(GetRewindTimestamp(ActorInfo, EventData), Start, End, QueryRadius, RewoundHits);
+
+	const float TraceLength = FVector::Dist(Start, End);
+	const bool bSingle = TraceHitType == EGASXTraceHitType::THT_SingleTrace;
+	float BlockingTime = InOutHitResults.Num() > 0 && InOutHitResults.Last().bBlockingHit ? InOutHitResults.Last().Time : 1.f;
+
+	for (const FGASXRewoundHit& RewoundHit : RewoundHits)
+	{
+		if (RewoundHit.Time > BlockingTime || QueryParams.GetIgnoredActors().Contains(RewoundHit.Actor->GetUniqueID()))
+		{
+			continue;
+		}
+
+		const FVector Location = FMath::Lerp(Start, End, RewoundHit.Time);
+		const FVector CapsulePoint = FMath::ClosestPointOnSegment(Location, RewoundHit.CapsuleA, RewoundHit.CapsuleB);
+
+		FHitResult HitResult(RewoundHit.Actor, RewoundHit.Actor->GetRootComponent() ? Cast<UPrimitiveComponent>(RewoundHit.Actor->GetRootComponent()) : nullptr, Location, (Location - CapsulePoint).GetSafeNormal());
+		HitResult.TraceStart = Start;
+		HitResult.TraceEnd = End;
+		HitResult.Time = RewoundHit.Time;
+		HitResult.Distance = TraceLength * RewoundHit.Time;
+		HitResult.ImpactPoint = CapsulePoint + HitResult.ImpactNormal * RewoundHit.CapsuleRadius;
+		HitResult.bBlockingHit = true;
+
+		if (bSingle)
+		{
+			// Keep the closest hit only
+			InOutHitResults.Reset();
+			BlockingTime = RewoundHit.Time;
+		}
+		InOutHitResults.Add(HitResult);
+	}
+
+	InOutHitResults.Sort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+	return InOutHitResults.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+}
+
+FTraceHandle UGASXTargetType_TraceBase::GetTargetsAsync(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXTargetsReadyDelegate OnTargetsReady) const
+{
+	UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo));
+	if (!World || bBlueprintGetTargets || ShouldLagCompensate(ActorInfo) || (CollisionQuery.TargetType == EGASXTraceTargetType::TTT_ByObjectTypes && !CollisionQuery.ObjectQueryParams.IsValid()))
+	{
+		return Super::GetTargetsAsync(ActorInfo, EventData, OnTargetsReady);
+	}
+
+	FVector Start, End;
+	DispatchGetTraceStartAndEnd(ActorInfo, EventData, Start, End);
+
+	FCollisionQueryParams QueryParams;
+	MakeQueryParams(ActorInfo, EventData, QueryParams);
+
+	TWeakObjectPtr<const UGASXTargetType_TraceBase> WeakThis(this);
+	const FTraceDelegate TraceDelegate = FTraceDelegate::CreateLambda([WeakThis, ActorInfo, OnTargetsReady](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+		{
+			if (const UGASXTargetType_TraceBase* StrongThis = WeakThis.Get())
+			{
+				StrongThis->OnAsyncTraceCompleted(TraceDatum, ActorInfo, OnTargetsReady);
+			}
+		});
+
+	const FTraceHandle TraceHandle = PerformAsyncTrace(World, Start, End, QueryParams, TraceDelegate);
+	if (!TraceHandle.IsValid())
+	{
+		return Super::GetTargetsAsync(ActorInfo, EventData, OnTargetsReady);
+	}
+	return TraceHandle;
+}
+
+void UGASXTargetType_TraceBase::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BuildCollisionQuery();
+}
+
+void UGASXTargetType_TraceBase::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildCollisionQuery();
+}
+
+#if WITH_EDITOR
+void UGASXTargetType_TraceBase::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildCollisionQuery();
+}
+#endif
+
+void UGASXTargetType_TraceBase::BuildCollisionQuery()
+{
+	CollisionQuery.TargetType = TraceTargetType;
+	CollisionQuery.Channel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	CollisionQuery.ProfileName = ProfileName.Name;
+
+	CollisionQuery.ObjectQueryParams = FCollisionObjectQueryParams();
+	for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : ObjectTypes)
+	{
+		const ECollisionChannel ObjectChannel = UEngineTypes::ConvertToCollisionChannel(ObjectType);
+		if (FCollisionObjectQueryParams::IsValidObjectQuery(ObjectChannel))
+		{
+			CollisionQuery.ObjectQueryParams.AddObjectTypesToQuery(ObjectChannel);
+		}
+	}
+
+	// Same setup as UKismetSystemLibrary traces so results don't change.
+	CollisionQuery.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GASXTargetTypeTrace), bTraceComplex);
+	CollisionQuery.QueryParams.bReturnPhysicalMaterial = true;
+	CollisionQuery.QueryParams.bReturnFaceIndex = !UPhysicsSettings::Get()->bSuppressFaceRemapTable;
+
+	CollisionQuery.ShapeRotation = FQuat::Identity;
+	switch (TraceShapeType)
+	{
+	case EGASXTraceShapeType::TST_SphereTrace:
+		CollisionQuery.Shape = FCollisionShape::MakeSphere(TraceRadius);
+		break;
+	case EGASXTraceShapeType::TST_CapsuleTrace:
+		CollisionQuery.Shape = FCollisionShape::MakeCapsule(TraceRadius, CapsuleTraceHalfHeight);
+		break;
+	case EGASXTraceShapeType::TST_BoxTrace:
+		CollisionQuery.Shape = FCollisionShape::MakeBox(BoxTraceHalfSize);
+		CollisionQuery.ShapeRotation = BoxTraceOrientation.Quaternion();
+		break;
+	case EGASXTraceShapeType::TST_LineTrace:
+	default:
+		CollisionQuery.Shape = FCollisionShape();
+		break;
+	}
+	CollisionQuery.bIsLineTrace = TraceShapeType == EGASXTraceShapeType::TST_LineTrace;
+}
+
+bool UGASXTargetType_TraceBase::PerformTrace(const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, TArray<FHitResult>& OutHitResults) const
+{
+	const FGASXCollisionQuery& Query = CollisionQuery;
+	bool bHit = false;
+
+	if (Query.TargetType == EGASXTraceTargetType::TTT_ByObjectTypes && !Query.ObjectQueryParams.IsValid())
+	{
+		return false;
+	}
+
+	if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
+	{
+		FHitResult SingleHitResult;
+		bHit = PerformSingleTrace(World, Start, End, QueryParams, SingleHitResult);
+
+#if ENABLE_DRAW_DEBUG
+		DrawDebugTraceSingle(World, Start, End, bHit, SingleHitResult);
+#endif
+
+		if (bHit) OutHitResults.Add(SingleHitResult);
+	}
+	else if (TraceHitType == EGASXTraceHitType::THT_MultiTrace)
+	{
+		switch (Query.TargetType)
+		{
+		case EGASXTraceTargetType::TTT_ByChannel:
+			bHit = Query.bIsLineTrace
+				? World->LineTraceMultiByChannel(OutHitResults, Start, End, Query.Channel, QueryParams)
+				: World->SweepMultiByChannel(OutHitResults, Start, End, Query.ShapeRotation, Query.Channel, Query.Shape, QueryParams);
+			break;
+		case EGASXTraceTargetType::TTT_ByProfile:
+			bHit = Query.bIsLineTrace
+				? World->LineTraceMultiByProfile(OutHitResults, Start, End, Query.ProfileName, QueryParams)
+				: World->SweepMultiByProfile(OutHitResults, Start, End, Query.ShapeRotation, Query.ProfileName, Query.Shape, QueryParams);
+			break;
+		case EGASXTraceTargetType::TTT_ByObjectTypes:
+			bHit = Query.bIsLineTrace
+				? World->LineTraceMultiByObjectType(OutHitResults, Start, End, Query.ObjectQueryParams, QueryParams)
+				: World->SweepMultiByObjectType(OutHitResults, Start, End, Query.ShapeRotation, Query.ObjectQueryParams, Query.Shape, QueryParams);
+			break;
+		default:
+			break;
+		}
+
+#if ENABLE_DRAW_DEBUG
+		DrawDebugTraceMulti(World, Start, End, bHit, OutHitResults);
+#endif
+	}
+
+	return bHit;
+}
+
+bool UGASXTargetType_TraceBase::PerformSingleTrace(const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, FHitResult& OutHitResult) const
+{
+	const FGASXCollisionQuery& Query = CollisionQuery;
+	switch (Query.TargetType)
+	{
+	case EGASXTraceTargetType::TTT_ByChannel:
+		return Query.bIsLineTrace
+			? World->LineTraceSingleByChannel(OutHitResult, Start, End, Query.Channel, QueryParams)
+			: World->SweepSingleByChannel(OutHitResult, Start, End, Query.ShapeRotation, Query.Channel, Query.Shape, QueryParams);
+	case EGASXTraceTargetType::TTT_ByProfile:
+		return Query.bIsLineTrace
+			? World->LineTraceSingleByProfile(OutHitResult, Start, End, Query.ProfileName, QueryParams)
+			: World->SweepSingleByProfile(OutHitResult, Start, End, Query.ShapeRotation, Query.ProfileName, Query.Shape, QueryParams);
+	case EGASXTraceTargetType::TTT_ByObjectTypes:
+		return Query.ObjectQueryParams.IsValid() && (Query.bIsLineTrace
+			? World->LineTraceSingleByObjectType(OutHitResult, Start, End, Query.ObjectQueryParams, QueryParams)
+			: World->SweepSingleByObjectType(OutHitResult, Start, End, Query.ShapeRotation, Query.ObjectQueryParams, Query.Shape, QueryParams));
+	default:
+		break;
+	}
+	return false;
+}
+
+FTraceHandle UGASXTargetType_TraceBase::PerformAsyncTrace(UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, const FTraceDelegate& TraceDelegate) const
+{
+	const FGASXCollisionQuery& Query = CollisionQuery;
+	const EAsyncTraceType AsyncTraceType = TraceHitType == EGASXTraceHitType::THT_MultiTrace ? EAsyncTraceType::Multi : EAsyncTraceType::Single;
+
+	switch (Query.TargetType)
+	{
+	case EGASXTraceTargetType::TTT_ByChannel:
+		return Query.bIsLineTrace
+			? World->AsyncLineTraceByChannel(AsyncTraceType, Start, End, Query.Channel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate)
+			: World->AsyncSweepByChannel(AsyncTraceType, Start, End, Query.ShapeRotation, Query.Channel, Query.Shape, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate);
+	case EGASXTraceTargetType::TTT_ByProfile:
+		return Query.bIsLineTrace
+			? World->AsyncLineTraceByProfile(AsyncTraceType, Start, End, Query.ProfileName, QueryParams, &TraceDelegate)
+			: World->AsyncSweepByProfile(AsyncTraceType, Start, End, Query.ShapeRotation, Query.ProfileName, Query.Shape, QueryParams, &TraceDelegate);
+	case EGASXTraceTargetType::TTT_ByObjectTypes:
+		return Query.bIsLineTrace
+			? World->AsyncLineTraceByObjectType(AsyncTraceType, Start, End, Query.ObjectQueryParams, QueryParams, &TraceDelegate)
+			: World->AsyncSweepByObjectType(AsyncTraceType, Start, End, Query.ShapeRotation, Query.ObjectQueryParams, Query.Shape, QueryParams, &TraceDelegate);
+	default:
+		break;
+	}
+	return FTraceHandle();
+}
+
+void UGASXTargetType_TraceBase::OnAsyncTraceCompleted(FTraceDatum& TraceDatum, const FGameplayAbilityActorInfo& ActorInfo, const FGASXTargetsReadyDelegate& OnTargetsReady) const
+{
+	TArray<FHitResult> HitResults = MoveTemp(TraceDatum.OutHits);
+	TArray<AActor*> Actors;
+
+	// Same as the return value of the sync queries: true only if there is a blocking hit.
+	const bool bHit = HitResults.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+
+#if ENABLE_DRAW_DEBUG
+	if (const UWorld* World = TraceDatum.PhysWorld.Get())
+	{
+		if (TraceHitType == EGASXTraceHitType::THT_SingleTrace)
+		{
+			DrawDebugTraceSingle(World, TraceDatum.Start, TraceDatum.End, bHit, bHit ? HitResults[0] : FHitResult());
+		}
+		else
+		{
+			DrawDebugTraceMulti(World, TraceDatum.Start, TraceDatum.End, bHit, HitResults);
+		}
+	}
+#endif
+
+	SelectTargets(ActorInfo, TraceDatum.Start, TraceDatum.End, bHit && bHitActorsAsTargets, HitResults, Actors);
+
+	DispatchFilterTargets(ActorInfo, HitResults, Actors);
+	TrimToMaxTargets(bHit && bHitActorsAsTargets, HitResults, Actors);
+
+	OnTargetsReady.ExecuteIfBound(HitResults, Actors);
+}
+
+#if ENABLE_DRAW_DEBUG
+void UGASXTargetType_TraceBase::DrawDebugTraceSingle(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const FHitResult& HitResult) const
+{
+	if (DrawDebugType == EDrawDebugTrace::None)
+	{
+		return;
+	}
+
+	switch (TraceShapeType)
+	{
+	case EGASXTraceShapeType::TST_LineTrace:
+		DrawDebugLineTraceSingle(World, Start, End, DrawDebugType, bHit, HitResult, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_SphereTrace:
+		DrawDebugSphereTraceSingle(World, Start, End, TraceRadius, DrawDebugType, bHit, HitResult, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_CapsuleTrace:
+		DrawDebugCapsuleTraceSingle(World, Start, End, TraceRadius, CapsuleTraceHalfHeight, DrawDebugType, bHit, HitResult, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_BoxTrace:
+		DrawDebugBoxTraceSingle(World, Start, End, BoxTraceHalfSize, BoxTraceOrientation, DrawDebugType, bHit, HitResult, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	default:
+		break;
+	}
+}
+
+void UGASXTargetType_TraceBase::DrawDebugTraceMulti(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const TArray<FHitResult>& HitResults) const
+{
+	if (DrawDebugType == EDrawDebugTrace::None)
+	{
+		return;
+	}
+
+	switch (TraceShapeType)
+	{
+	case EGASXTraceShapeType::TST_LineTrace:
+		DrawDebugLineTraceMulti(World, Start, End, DrawDebugType, bHit, HitResults, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_SphereTrace:
+		DrawDebugSphereTraceMulti(World, Start, End, TraceRadius, DrawDebugType, bHit, HitResults, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_CapsuleTrace:
+		DrawDebugCapsuleTraceMulti(World, Start, End, TraceRadius, CapsuleTraceHalfHeight, DrawDebugType, bHit, HitResults, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	case EGASXTraceShapeType::TST_BoxTrace:
+		DrawDebugBoxTraceMulti(World, Start, End, BoxTraceHalfSize, BoxTraceOrientation, DrawDebugType, bHit, HitResults, DebugTraceColor, DebugTraceHitColor, DebugDrawTime);
+		break;
+	default:
+		break;
+	}
+}
+#endif
+
+////////////////////
+///// UGASXTargetType_TraceFromAvatarActor
+
+void UGASXTargetType_TraceFromAvatarActor::NativeGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const
+{
+	FTransform BaseTransform = GetSceneObjectTransform(ActorInfo);
+	FVector BaseForward = BaseTransform.GetUnitAxis(EAxis::X);
+
+	OutStart = BaseTransform.TransformPosition(OffsetFromActor);
+	OutEnd = BaseTransform.GetLocation() + BaseForward * TraceLength;
+}
+
+////////////////////
+///// UGASXTargetType_OverlapBase
+
+void UGASXTargetType_OverlapBase::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BuildOverlapQuery();
+}
+
+void UGASXTargetType_OverlapBase::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildOverlapQuery();
+}
+
+#if WITH_EDITOR
+void UGASXTargetType_OverlapBase::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildOverlapQuery();
+}
+#endif
+
+FTransform UGASXTargetType_OverlapBase::GetOverlapOrigin(const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	FTransform Origin = GASXTargetTypeHelpers::GetSceneObjectTransform(SceneObjectType, ActorInfo);
+	Origin.SetLocation(Origin.TransformPosition(OriginOffset));
+	Origin.SetScale3D(FVector::OneVector);
+	return Origin;
+}
+
+void UGASXTargetType_OverlapBase::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	if (const UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo)))
+	{
+		const FTransform Origin = GetOverlapOrigin(ActorInfo);
+
+		FCollisionQueryParams QueryParams = CollisionQuery.QueryParams;
+		if (bIgnoreAvatarActor && ActorInfo.AvatarActor.IsValid())
+		{
+			QueryParams.AddIgnoredActor(ActorInfo.AvatarActor.Get());
+		}
+
+		// Only filter what this query adds
+		TArray<AActor*> Candidates;
+		PerformOverlap(World, Origin, QueryParams, Candidates);
+		FilterCandidates(Origin, Candidates);
+		OutActors.Append(MoveTemp(Candidates));
+
+#if ENABLE_DRAW_DEBUG
+		if (DrawDebugType != EDrawDebugTrace::None)
+		{
+			DrawDebugOverlap(World, Origin);
+		}
+#endif
+	}
+
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
+}
+
+void UGASXTargetType_OverlapBase::BuildOverlapQuery()
+{
+	CollisionQuery.TargetType = OverlapTargetType;
+	CollisionQuery.Channel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	CollisionQuery.ProfileName = ProfileName.Name;
+
+	CollisionQuery.ObjectQueryParams = FCollisionObjectQueryParams();
+	for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : ObjectTypes)
+	{
+		const ECollisionChannel ObjectChannel = UEngineTypes::ConvertToCollisionChannel(ObjectType);
+		if (FCollisionObjectQueryParams::IsValidObjectQuery(ObjectChannel))
+		{
+			CollisionQuery.ObjectQueryParams.AddObjectTypesToQuery(ObjectChannel);
+		}
+	}
+
+	CollisionQuery.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(GASXTargetTypeOverlap), false);
+	CollisionQuery.Shape = FCollisionShape();
+	CollisionQuery.ShapeRotation = FQuat::Identity;
+	CollisionQuery.bIsLineTrace = false;
+
+	CandidateFilter = FGASXCandidateFilter();
+	if (bFilterByHeight)
+	{
+		CandidateFilter.MinHeight = MinHeight;
+		CandidateFilter.MaxHeight = MaxHeight;
+	}
+}
+
+void UGASXTargetType_OverlapBase::PerformOverlap(const UWorld* World, const FTransform& Origin, const FCollisionQueryParams& QueryParams, TArray<AActor*>& OutActors) const
+{
+	const FGASXCollisionQuery& Query = CollisionQuery;
+	const FVector Location = Origin.GetLocation();
+	const FQuat Rotation = Origin.GetRotation() * Query.ShapeRotation;
+
+	TArray<FOverlapResult> Overlaps;
+	switch (Query.TargetType)
+	{
+	case EGASXTraceTargetType::TTT_ByChannel:
+		World->OverlapMultiByChannel(Overlaps, Location, Rotation, Query.Channel, Query.Shape, QueryParams);
+		break;
+	case EGASXTraceTargetType::TTT_ByProfile:
+		World->OverlapMultiByProfile(Overlaps, Location, Rotation, Query.ProfileName, Query.Shape, QueryParams);
+		break;
+	case EGASXTraceTargetType::TTT_ByObjectTypes:
+		if (Query.ObjectQueryParams.IsValid())
+		{
+			World->OverlapMultiByObjectType(Overlaps, Location, Rotation, Query.ObjectQueryParams, Query.Shape, QueryParams);
+		}
+		break;
+	default:
+		break;
+	}
+
+	// An actor is reported once per overlapped component
+	TSet<AActor*, DefaultKeyFuncs<AActor*>, TInlineSetAllocator<32>> UniqueActors;
+	OutActors.Reserve(OutActors.Num() + Overlaps.Num());
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* OverlapActor = Overlap.GetActor();
+		if (!OverlapActor) continue;
+
+		bool bAlreadyInSet = false;
+		UniqueActors.Add(OverlapActor, &bAlreadyInSet);
+		if (!bAlreadyInSet) OutActors.Add(OverlapActor);
+	}
+}
+
+void UGASXTargetType_OverlapBase::FilterCandidates(const FTransform& Origin, TArray<AActor*>& InOutActors) const
+{
+	const int32 NumCandidates = InOutActors.Num();
+	if (NumCandidates == 0)
+	{
+		return;
+	}
+
+	// Pack positions relative to the origin into SoA arrays, padded to a multiple of 4 for the vector loop.
+	const int32 NumPadded = Align(NumCandidates, 4);
+	TArray<float, TInlineAllocator<64>> X, Y, Z;
+	X.SetNumZeroed(NumPadded);
+	Y.SetNumZeroed(NumPadded);
+	Z.SetNumZeroed(NumPadded);
+
+	const FVector OriginLocation = Origin.GetLocation();
+	for (int32 Index = 0; Index < NumCandidates; ++Index)
+	{
+		const FVector Relative = InOutActors[Index]->GetActorLocation() - OriginLocation;
+		X[Index] = (float)Relative.X;
+		Y[Index] = (float)Relative.Y;
+		Z[Index] = (float)Relative.Z;
+	}
+
+	TArray<int32, TInlineAllocator<64>> PassingIndices;
+	GASXTargetTypeHelpers::FilterCandidatePositions(CandidateFilter, FVector3f(Origin.GetUnitAxis(EAxis::X)), FVector3f(Origin.GetUnitAxis(EAxis::Z)), X.GetData(), Y.GetData(), Z.GetData(), NumCandidates, PassingIndices);
+
+	// Indices are ascending, so compact in place.
+	for (int32 Index = 0; Index < PassingIndices.Num(); ++Index)
+	{
+		InOutActors[Index] = InOutActors[PassingIndices[Index]];
+	}
+	InOutActors.SetNum(PassingIndices.Num(), EAllowShrinking::No);
+}
+
+////////////////////
+///// UGASXTargetType_OverlapSphere
+
+void UGASXTargetType_OverlapSphere::BuildOverlapQuery()
+{
+	Super::BuildOverlapQuery();
+
+	CollisionQuery.Shape = FCollisionShape::MakeSphere(Radius);
+	CandidateFilter.MaxDistanceSquared = FMath::Square(Radius);
+}
+
+#if ENABLE_DRAW_DEBUG
+void UGASXTargetType_OverlapSphere::DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const
+{
+	::DrawDebugSphere(World, Origin.GetLocation(), Radius, 16, DebugShapeColor.ToFColor(true), IsDebugPersistent(), GetDebugLifeTime());
+}
+#endif
+
+////////////////////
+///// UGASXTargetType_OverlapBox
+
+void UGASXTargetType_OverlapBox::BuildOverlapQuery()
+{
+	Super::BuildOverlapQuery();
+
+	CollisionQuery.Shape = FCollisionShape::MakeBox(BoxHalfExtent);
+	CollisionQuery.ShapeRotation = BoxOrientation.Quaternion();
+}
+
+#if ENABLE_DRAW_DEBUG
+void UGASXTargetType_OverlapBox::DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const
+{
+	::DrawDebugBox(World, Origin.GetLocation(), BoxHalfExtent, Origin.GetRotation() * CollisionQuery.ShapeRotation, DebugShapeColor.ToFColor(true), IsDebugPersistent(), GetDebugLifeTime());
+}
+#endif
+
+////////////////////
+///// UGASXTargetType_Cone
+
+void UGASXTargetType_Cone::BuildOverlapQuery()
+{
+	Super::BuildOverlapQuery();
+
+	// Broad phase with the sphere containing the cone, then exact distance and angle in the candidate filter.
+	CollisionQuery.Shape = FCollisionShape::MakeSphere(Range);
+	CandidateFilter.MaxDistanceSquared = FMath::Square(Range);
+	CandidateFilter.CosHalfAngle = HalfAngle >= 180.f ? -2.f : FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+}
+
+#if ENABLE_DRAW_DEBUG
+void UGASXTargetType_Cone::DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const
+{
+	const float HalfAngleRadians = FMath::DegreesToRadians(FMath::Min(HalfAngle, 179.f));
+	::DrawDebugCone(World, Origin.GetLocation(), Origin.GetUnitAxis(EAxis::X), Range, HalfAngleRadians, HalfAngleRadians, 16, DebugShapeColor.ToFColor(true), IsDebugPersistent(), GetDebugLifeTime());
+}
+#endif
+
+////////////////////
+///// UGASXTargetType_Hitbox
+
+void UGASXTargetType_Hitbox::NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	const UWorld* World = Cast<UWorld>(GetWorldContextObjectFromActorInfo(ActorInfo));
+	UGASXHitboxSubsystem* HitboxSubsystem = UWorld::GetSubsystem<UGASXHitboxSubsystem>(World);
+	if (!HitboxSubsystem)
+	{
+		DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
+		return;
+	}
+
+	const FTransform BaseTransform = GASXTargetTypeHelpers::GetSceneObjectTransform(SceneObjectType, ActorInfo);
+	const FVector Start = BaseTransform.TransformPosition(OriginOffset);
+	const FVector Direction = BaseTransform.GetUnitAxis(EAxis::X);
+	const FVector End = Start + Direction * Range;
+
+	TArray<FGASXHitboxHit> Hits;
+	switch (QueryShape)
+	{
+	case EGASXHitboxQueryShape::HQS_Ray:
+		HitboxSubsystem->SweepSphere(Start, End, 0.f, Hits);
+		break;
+	case EGASXHitboxQueryShape::HQS_Sphere:
+		HitboxSubsystem->SweepSphere(Start, End, Radius, Hits);
+		break;
+	case EGASXHitboxQueryShape::HQS_Cone:
+		HitboxSubsystem->OverlapCone(Start, Direction, Range, HalfAngle, Hits);
+		break;
+	default:
+		break;
+	}
+
+	// Closest capsule first, so the first hit of each actor is the one we keep.
+	Hits.Sort([](const FGASXHitboxHit& A, const FGASXHitboxHit& B) { return A.Time < B.Time; });
+
+	const AActor* IgnoredActor = bIgnoreAvatarActor ? ActorInfo.AvatarActor.Get() : nullptr;
+	TSet<AActor*, DefaultKeyFuncs<AActor*>, TInlineSetAllocator<32>> UniqueActors;
+	for (const FGASXHitboxHit& Hit : Hits)
+	{
+		AActor* HitActor = Hit.Component ? Hit.Component->GetOwner() : nullptr;
+		if (!HitActor || HitActor == IgnoredActor) continue;
+
+		bool bAlreadyInSet = false;
+		UniqueActors.Add(HitActor, &bAlreadyInSet);
+		if (bAlreadyInSet) continue;
+
+		if (bHitActorsAsTargets)
+		{
+			OutActors.Add(HitActor);
+			continue;
+		}
+
+		FVector CapsuleA, CapsuleB;
+		float CapsuleRadius;
+		Hit.Component->GetWorldCapsule(Hit.CapsuleIndex, CapsuleA, CapsuleB, CapsuleRadius);
+
+		const FVector QueryPoint = QueryShape == EGASXHitboxQueryShape::HQS_Cone ? Start + Direction * (Range * Hit.Time) : FMath::Lerp(Start, End, Hit.Time);
+		const FVector CapsulePoint = FMath::ClosestPointOnSegment(QueryPoint, CapsuleA, CapsuleB);
+
+		FHitResult& HitResult = OutHitResults.AddDefaulted_GetRef();
+		HitResult.HitObjectHandle = FActorInstanceHandle(HitActor);
+		HitResult.Component = Hit.Component->GetMeshComponent();
+		HitResult.BoneName = Hit.Component->GetCapsules()[Hit.CapsuleIndex].BoneName;
+		HitResult.TraceStart = Start;
+		HitResult.TraceEnd = End;
+		HitResult.Time = Hit.Time;
+		HitResult.Distance = FVector::Dist(Start, QueryPoint);
+		HitResult.Location = QueryPoint;
+		HitResult.ImpactNormal = (QueryPoint - CapsulePoint).GetSafeNormal();
+		HitResult.Normal = HitResult.ImpactNormal;
+		HitResult.ImpactPoint = CapsulePoint + HitResult.ImpactNormal * CapsuleRadius;
+		HitResult.bBlockingHit = true;
+	}
+
+	DispatchFilterTargets(ActorInfo, OutHitResults, OutActors);
 }
@@ -137,41 +137,58 @@ bool UGASXGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySyste
 	const FGameplayTag& BlockedTag = AbilitySystemGlobals.ActivateFailTagsBlockedTag;
 	const FGameplayTag& MissingTag = AbilitySystemGlobals.ActivateFailTagsMissingTag;
 
-	// Check if any of this ability's tags are currently blocked
-	if (AbilitySystemComponent.AreAbilityTagsBlocked(AbilityTags))
+	const UGASXAbilitySystemComponent* ASC = Cast<UGASXAbilitySystemComponent>(&AbilitySystemComponent);
+	const bool bCanUseCache = ASC && !HasAnyFlags(RF_ClassDefaultObject);
+	if (bCanUseCache && TagRequirementsCacheASC.Get() == ASC && TagRequirementsCacheGeneration == ASC->GetOwnedTagsGeneration())
 	{
-		bBlocked = true;
+		bBlocked = bTagRequirementsCacheBlocked;
+		bMissing = bTagRequirementsCacheMissing;
 	}
+	else
+	{
+		// Check if any of this ability's tags are currently blocked
+		if (AbilitySystemComponent.AreAbilityTagsBlocked(AbilityTags))
+		{
+			bBlocked = true;
+		}
 
-	const UGASXAbilitySystemComponent* ASC = Cast<UGASXAbilitySystemComponent>(&AbilitySystemComponent);
-	static FGameplayTagContainer AllRequiredTags;
-	static FGameplayTagContainer AllBlockedTags;
+		static FGameplayTagContainer AllRequiredTags;
+		static FGameplayTagContainer AllBlockedTags;
 
-	AllRequiredTags = ActivationRequiredTags;
-	AllBlockedTags = ActivationBlockedTags;
+		AllRequiredTags = ActivationRequiredTags;
+		AllBlockedTags = ActivationBlockedTags;
 
-	// Expand our ability tags to add additional required/blocked tags
-	if (ASC)
-	{
-		ASC->GetAdditionalActivationTagRequirements(AbilityTags, AllRequiredTags, AllBlockedTags);
-	}
+		// Expand our ability tags to add additional required/blocked tags
+		if (ASC)
+		{
+			ASC->GetAdditionalActivationTagRequirements(AbilityTags, AllRequiredTags, AllBlockedTags);
+		}
 
-	// Check to see the required/blocked tags for this ability
-	if (AllBlockedTags.Num() || AllRequiredTags.Num())
-	{
-		static FGameplayTagContainer AbilitySystemComponentTags;
+		// Check to see the required/blocked tags for this ability
+		if (AllBlockedTags.Num() || AllRequiredTags.Num())
+		{
+			static FGameplayTagContainer AbilitySystemComponentTags;
 
-		AbilitySystemComponentTags.Reset();
-		AbilitySystemComponent.GetOwnedGameplayTags(AbilitySystemComponentTags);
+			AbilitySystemComponentTags.Reset();
+			AbilitySystemComponent.GetOwnedGameplayTags(AbilitySystemComponentTags);
 
-		if (AbilitySystemComponentTags.HasAny(AllBlockedTags))
-		{
-			bBlocked = true;
+			if (AbilitySystemComponentTags.HasAny(AllBlockedTags))
+			{
+				bBlocked = true;
+			}
+
+			if (!AbilitySystemComponentTags.HasAll(AllRequiredTags))
+			{
+				bMissing = true;
+			}
 		}
 
-		if (!AbilitySystemComponentTags.HasAll(AllRequiredTags))
+		if (bCanUseCache)
 		{
-			bMissing = true;
+			TagRequirementsCacheASC = ASC;
+			TagRequirementsCacheGeneration = ASC->GetOwnedTagsGeneration();
+			bTagRequirementsCacheBlocked = bBlocked;
+			bTagRequirementsCacheMissing = bMissing;
 		}
 	}
 
@@ -244,19 +261,23 @@ bool UGASXGameplayAbility::IsUsingGASXCooldownGEClass() const
 
 FGASXGameplayEffectContainerSpec UGASXGameplayAbility::MakeEffectContainerSpecFromContainer(const FGASXGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel)
 {
-	// First figure out our actor info
-	FGASXGameplayEffectContainerSpec ReturnSpec;
+	FGASXGameplayEffectContainerSpec ReturnSpec = MakeEffectContainerSpecWithoutTargets(Container, OverrideGameplayLevel);
 
 	// If we have a target type, run the targeting logic. This is optional, targets can be added later
-	if (Container.TargetType.Get())
+	if (Container.TargetType.Get() && CurrentActorInfo)
 	{
 		TArray<FHitResult> HitResults;
 		TArray<AActor*> TargetActors;
 		const UGASXTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject();
-		AActor* AvatarActor = GetAvatarActorFromActorInfo();
-		TargetTypeCDO->GetTargets(GetActorInfo(), EventData, HitResults, TargetActors);
+		TargetTypeCDO->GetTargetsCached(*CurrentActorInfo, EventData, HitResults, TargetActors);
 		ReturnSpec.AddTargets(HitResults, TargetActors);
 	}
+	return ReturnSpec;
+}
+
+FGASXGameplayEffectContainerSpec UGASXGameplayAbility::MakeEffectContainerSpecWithoutTargets(const FGASXGameplayEffectContainer& Container, int32 OverrideGameplayLevel)
+{
+	FGASXGameplayEffectContainerSpec ReturnSpec;
 
 	// If we don't have an override level, use the default on the ability itself
 	if (OverrideGameplayLevel == INDEX_NONE)
@@ -312,7 +333,42 @@ void UGASXGameplayAbility::TryActivateAbilityOnSpawn(const FGameplayAbilityActor
 		// If avatar actor is torn off or about to die, don't try to activate until we get the new one.
 		if (ASC && AvatarActor && !AvatarActor->GetTearOff() && (AvatarActor->GetLifeSpan() <= 0.0f))
 		{
-			ASC->TryActivateAbility(Spec.Handle);
+			if (UGASXAbilitySystemComponent* GASXASC = Cast<UGASXAbilitySystemComponent>(ASC))
+			{
+				GASXASC->TryActivateAbilityBatched(Spec.Handle);
+			}
+			else
+			{
+				ASC->TryActivateAbility(Spec.Handle);
+			}
 		}
 	}
 }
+
+void UGASXGameplayAbility::SendGameplayEvents(TConstArrayView<FGameplayTag> EventTags, FGameplayEventData& Payload)
+{
+	UAbilitySystemComponent* ASC = CurrentActorInfo ? CurrentActorInfo->AbilitySystemComponent.Get() : nullptr;
+	if (!ASC)
+	{
+		return;
+	}
+
+	FScopedPredictionWindow NewScopedWindow(ASC, true);
+	for (const FGameplayTag& EventTag : EventTags)
+	{
+		Payload.EventTag = EventTag;
+		ASC->HandleGameplayEvent(EventTag, &Payload);
+	}
+}
+
+void UGASXGameplayAbility::SendTargetDataToServer(const FGameplayAbilityTargetDataHandle& TargetData, FGameplayTag ApplicationTag)
+{
+	UAbilitySystemComponent* ASC = CurrentActorInfo ? CurrentActorInfo->AbilitySystemComponent.Get() : nullptr;
+	if (!ASC || CurrentActorInfo->IsNetAuthority())
+	{
+		return;
+	}
+
+	FScopedPredictionWindow ScopedPrediction(ASC, IsPredictingClient());
+	ASC->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), TargetData, ApplicationTag, ASC->ScopedPredictionKey);
+}
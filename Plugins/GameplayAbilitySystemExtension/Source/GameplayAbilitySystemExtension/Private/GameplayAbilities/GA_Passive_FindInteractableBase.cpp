@@ -8,6 +8,21 @@
 #include "AbilitySystemComponent.h"
 #include "GASXMacroDefinitions.h"
 #include "GASXTargetType.h"
+#include "Interaction/GASXInteractionSubsystem.h"
+#include "Interaction/GASXInteractableRegistrySubsystem.h"
+#include "Interaction/GASXInteractableComponent.h"
+#include "Engine/World.h"
+#include "GASXAbilitySystemComponent.h"
+#include "Misc/ScopeExit.h"
+
+DECLARE_CYCLE_STAT(TEXT("Find Interactable"), STAT_GASXFindInteractable, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Scan Buffer Growths"), STAT_GASXInteractionScanBufferGrowths, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Scans Executed"), STAT_GASXInteractionScansExecuted, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Scans Skipped"), STAT_GASXInteractionScansSkipped, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Traces"), STAT_GASXInteractionTraces, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Candidates"), STAT_GASXInteractionCandidates, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Targets Found"), STAT_GASXInteractionTargetsFound, STATGROUP_GASXInteraction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Targets Lost"), STAT_GASXInteractionTargetsLost, STATGROUP_GASXInteraction);
 
 namespace GASXConsoleVariables
 {
@@ -19,9 +34,38 @@ namespace GASXConsoleVariables
 		ECVF_Cheat);
 }
 
+namespace GASXFindInteractable
+{
+	// Points into the target data instead of copying the hit like UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData().
+	static const FHitResult* GetFirstHitResult(const FGameplayAbilityTargetDataHandle& TargetData)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(0);
+		return Data ? Data->GetHitResult() : nullptr;
+	}
+
+	static const UPrimitiveComponent* GetFirstHitComponent(const FGameplayAbilityTargetDataHandle& TargetData)
+	{
+		const FHitResult* HitResult = GetFirstHitResult(TargetData);
+		return HitResult ? HitResult->GetComponent() : nullptr;
+	}
+}
+
 UGA_Passive_FindInteractableBase::UGA_Passive_FindInteractableBase()
 	: Super()
 	, TimerPeriod(0.1f)
+	, bUseScanScheduler(false)
+	, bScanOnOwningClientOnly(false)
+	, bAdaptiveScan(false)
+	, AdaptiveMoveThreshold(5.f)
+	, AdaptiveRotationThreshold(2.f)
+	, AdaptiveCoarseRadius(1000.f)
+	, AdaptiveMinPeriod(0.05f)
+	, AdaptiveMaxPeriod(0.5f)
+	, bUseInteractableRegistry(false)
+	, RegistryQueryRadius(300.f)
+	, RegistryQueryHalfAngle(60.f)
+	, MaxLineOfSightTraces(3)
+	, LineOfSightChannel(ECC_Visibility)
 	, bBlockInteractionIfTargetWasLost(false)
 {
 	ActivationPolicy = EGASXAbilityActivationPolicy::OnSpawn;	// Passive ability
@@ -31,11 +75,28 @@ void UGA_Passive_FindInteractableBase::ActivateAbility(const FGameplayAbilitySpe
 {
 	Super::ActivateAbility(Handle, OwnerInfo, ActivationInfo, TriggerEventData);
 
+	CacheBlueprintOverrides();
+
+	// The owning client scans for remote players.
+	if (bScanOnOwningClientOnly && !OwnerInfo->IsLocallyControlled())
+	{
+		return;
+	}
+
 	auto ASC = OwnerInfo->AbilitySystemComponent.Get();
 	if (ASC)
 	{
 		if (UWorld* World = GetWorld())
 		{
+			if (bUseScanScheduler)
+			{
+				if (UGASXInteractionSubsystem* InteractionSubsystem = World->GetSubsystem<UGASXInteractionSubsystem>())
+				{
+					InteractionSubsystem->RegisterScanner(this);
+					return;
+				}
+			}
+
 			World->GetTimerManager().SetTimer(TimerHandle_LoopFindInteractable, this, &UGA_Passive_FindInteractableBase::TickFindInteractable, TimerPeriod, FTimerManagerTimerParameters{ .bLoop = true, .bMaxOncePerFrame = true, .FirstDelay = TimerPeriod });
 			return;
 		}
@@ -48,27 +109,180 @@ void UGA_Passive_FindInteractableBase::EndAbility(const FGameplayAbilitySpecHand
 {
 	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
 
+	WatchInteractable(nullptr);
+
 	if (UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().ClearTimer(TimerHandle_LoopFindInteractable);
+
+		if (UGASXInteractionSubsystem* InteractionSubsystem = World->GetSubsystem<UGASXInteractionSubsystem>())
+		{
+			InteractionSubsystem->UnregisterScanner(this);
+		}
 	}
 }
 
+void UGA_Passive_FindInteractableBase::CacheBlueprintOverrides()
+{
+	const UClass* Class = GetClass();
+	bBlueprintTryFindTargetInteractable = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGA_Passive_FindInteractableBase, TryFindTargetInteractable));
+	bBlueprintGetTargets = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGA_Passive_FindInteractableBase, GetTargets));
+	bBlueprintIsTargetDataValid = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGA_Passive_FindInteractableBase, IsTargetDataValid));
+}
+
+bool UGA_Passive_FindInteractableBase::DispatchTryFindTargetInteractable(FGameplayAbilityTargetDataHandle& OutTargetDataHandle)
+{
+	return bBlueprintTryFindTargetInteractable ? TryFindTargetInteractable(OutTargetDataHandle) : TryFindTargetInteractable_Implementation(OutTargetDataHandle);
+}
+
+bool UGA_Passive_FindInteractableBase::DispatchGetTargets(TArray<FHitResult>& OutHitResults)
+{
+	return bBlueprintGetTargets ? GetTargets(OutHitResults) : GetTargets_Implementation(OutHitResults);
+}
+
+bool UGA_Passive_FindInteractableBase::DispatchIsTargetDataValid(const FGameplayAbilityTargetDataHandle& InTargetData)
+{
+	return bBlueprintIsTargetDataValid ? IsTargetDataValid(InTargetData) : IsTargetDataValid_Implementation(InTargetData);
+}
+
+bool UGA_Passive_FindInteractableBase::IsHitResultValid(const FHitResult& HitResult)
+{
+	if (bBlueprintIsTargetDataValid)
+	{
+		return IsTargetDataValid(UAbilitySystemBlueprintLibrary::AbilityTargetDataFromHitResult(HitResult));
+	}
+
+	const AActor* Avatar = CurrentActorInfo ? CurrentActorInfo->AvatarActor.Get() : nullptr;
+	return Avatar && UGASXLibrary::IsHitResultValidForInteraction(HitResult, Avatar, true);
+}
+
+bool UGA_Passive_FindInteractableBase::CanReuseLastResult()
+{
+	const AActor* Avatar = GetAvatarActorFromActorInfo();
+	const FHitResult* LastHit = GASXFindInteractable::GetFirstHitResult(LastData);
+	const UPrimitiveComponent* LastComponent = LastHit ? LastHit->GetComponent() : nullptr;
+	if (!Avatar || !LastComponent || LastComponent->Mobility == EComponentMobility::Movable)
+	{
+		return false;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	Avatar->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+	if (FVector::DistSquared(ViewLocation, LastScanViewLocation) > FMath::Square(AdaptiveMoveThreshold)
+		|| (ViewRotation.Vector() | LastScanViewDirection) < FMath::Cos(FMath::DegreesToRadians(AdaptiveRotationThreshold)))
+	{
+		return false;
+	}
+
+	// Availability may have changed without the view changing.
+	return IsHitResultValid(*LastHit);
+}
+
+void UGA_Passive_FindInteractableBase::UpdateAdaptiveScanPeriod()
+{
+	const AActor* Avatar = GetAvatarActorFromActorInfo();
+	UWorld* World = GetWorld();
+	if (!Avatar || !World)
+	{
+		return;
+	}
+
+	const FVector AvatarLocation = Avatar->GetActorLocation();
+	const auto PeriodAtDistance = [this](float Distance) { return FMath::Lerp(AdaptiveMinPeriod, TimerPeriod, FMath::Clamp(Distance / FMath::Max(AdaptiveCoarseRadius, 1.f), 0.f, 1.f)); };
+	// Without a registry, an interactable may be nearby even without a target, so scans are never slower than TimerPeriod.
+	float NewPeriod = TimerPeriod;
+	if (UGASXInteractableRegistrySubsystem* Registry = World->GetSubsystem<UGASXInteractableRegistrySubsystem>())
+	{
+		// Only the registry can tell that nothing is nearby.
+		TArray<FGASXInteractableCandidate, TInlineAllocator<1>> Nearest;
+		Registry->FindNearestInteractables(AvatarLocation, FVector::ForwardVector, AdaptiveCoarseRadius, -2.f, 1, Nearest);
+		NewPeriod = Nearest.Num() > 0 ? PeriodAtDistance(FMath::Sqrt(Nearest[0].DistanceSquared)) : AdaptiveMaxPeriod;
+	}
+	else if (const UPrimitiveComponent* LastComponent = GASXFindInteractable::GetFirstHitComponent(LastData))
+	{
+		NewPeriod = PeriodAtDistance((float)FVector::Dist(LastComponent->GetComponentLocation(), AvatarLocation));
+	}
+
+	if (!FMath::IsNearlyEqual(NewPeriod, CurrentScanPeriod, 0.01f))
+	{
+		CurrentScanPeriod = NewPeriod;
+
+		// UGASXInteractionSubsystem reads GetScanPeriod() itself.
+		if (TimerHandle_LoopFindInteractable.IsValid())
+		{
+			World->GetTimerManager().SetTimer(TimerHandle_LoopFindInteractable, this, &UGA_Passive_FindInteractableBase::TickFindInteractable, CurrentScanPeriod, FTimerManagerTimerParameters{ .bLoop = true, .bMaxOncePerFrame = true });
+		}
+	}
+}
+
+bool UGA_Passive_FindInteractableBase::HasActivatableInteractionAbility()
+{
+	UAbilitySystemComponent* ASC = CurrentActorInfo->AbilitySystemComponent.Get();
+
+	// Other ASCs don't tell when abilities change, so look them up every time.
+	UGASXAbilitySystemComponent* GASXASC = Cast<UGASXAbilitySystemComponent>(ASC);
+	const uint32 Generation = GASXASC ? GASXASC->GetAbilitiesGeneration() : 0;
+	if (Generation == 0 || Generation != InteractionAbilitiesGeneration)
+	{
+		const int32 OldMax = InteractionAbilityHandles.Max();
+		InteractionAbilityHandles.Reset();
+		for (const FGameplayAbilitySpec& Spec : ASC->GetActivatableAbilities())
+		{
+			if (Spec.Ability && Spec.Ability->AbilityTags.HasTag(InteractionAbilityTag))
+			{
+				InteractionAbilityHandles.Add(Spec.Handle);
+			}
+		}
+		InteractionAbilitiesGeneration = Generation;
+
+		if (InteractionAbilityHandles.Max() != OldMax)
+		{
+			INC_DWORD_STAT(STAT_GASXInteractionScanBufferGrowths);
+		}
+	}
+
+	for (const FGameplayAbilitySpecHandle& AbilityHandle : InteractionAbilityHandles)
+	{
+		const FGameplayAbilitySpec* Spec = GASXASC ? GASXASC->FindAbilitySpecFromHandleIndexed(AbilityHandle) : ASC->FindAbilitySpecFromHandle(AbilityHandle);
+		if (Spec && Spec->Ability && Spec->Ability->DoesAbilitySatisfyTagRequirements(*ASC))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void UGA_Passive_FindInteractableBase::TickFindInteractable()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GASXFindInteractable);
+	CSV_SCOPED_TIMING_STAT(GASXInteraction, FindInteractable);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	bool bSkipped = true;
+	ON_SCOPE_EXIT
+	{
+		GASX_INTERACTION_COUNT(ScansExecuted, bSkipped ? 0 : 1);
+		GASX_INTERACTION_COUNT(ScansSkipped, bSkipped ? 1 : 0);
+		UWorld* World = GetWorld();
+		if (UGASXInteractionSubsystem* InteractionSubsystem = World ? World->GetSubsystem<UGASXInteractionSubsystem>() : nullptr)
+		{
+			InteractionSubsystem->RecordScan(this, FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles), bSkipped);
+		}
+	};
+
 	if (CurrentActorInfo && InteractionAbilityTag.IsValid())
 	{
 		auto ASC = CurrentActorInfo->AbilitySystemComponent;
 		if (ASC.IsValid())
 		{
 			// Stops following operation if the owner ASC contains interaction abilities and any of them can be activated.  
-			TArray<FGameplayAbilitySpec*> InteractionAbilities;
-			ASC->GetActivatableGameplayAbilitySpecsByAllMatchingTags(FGameplayTagContainer(InteractionAbilityTag), InteractionAbilities, true);
-			if (InteractionAbilities.Num() == 0)
+			if (!HasActivatableInteractionAbility())
 			{
 				bIsInteractionBlocked = true;
 				CancelWaiting(true);
 				LastData.Clear();
+				WatchInteractable(nullptr);
 				return;
 			}
 			else
@@ -83,9 +297,28 @@ void UGA_Passive_FindInteractableBase::TickFindInteractable()
 		return;
 	}
 
-	bool bFoundValidData = false;
-	FGameplayAbilityTargetDataHandle FoundData;
-	bFoundValidData = TryFindTargetInteractable(FoundData);
+	if (bAdaptiveScan)
+	{
+		UpdateAdaptiveScanPeriod();
+		if (CanReuseLastResult())
+		{
+			return;
+		}
+
+		if (const AActor* Avatar = GetAvatarActorFromActorInfo())
+		{
+			FRotator ViewRotation;
+			Avatar->GetActorEyesViewPoint(LastScanViewLocation, ViewRotation);
+			LastScanViewDirection = ViewRotation.Vector();
+		}
+	}
+
+	bSkipped = false;
+
+	// Found data goes to a member so that copying target data into it reuses its allocation.
+	FGameplayAbilityTargetDataHandle& FoundData = ScratchTargetData;
+	FoundData.Clear();
+	const bool bFoundValidData = DispatchTryFindTargetInteractable(FoundData);
 	if (!bFoundValidData) FoundData.Clear();	// set empty data if not found.
 
 	if (bFoundValidData)
@@ -93,9 +326,9 @@ void UGA_Passive_FindInteractableBase::TickFindInteractable()
 		// Notifies target lost first, then notifies target found.
 
 		// Check if it is new target and NOT previous target
-		if (UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(FoundData, 0).GetComponent() != UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(LastData, 0).GetComponent())
+		if (GASXFindInteractable::GetFirstHitComponent(FoundData) != GASXFindInteractable::GetFirstHitComponent(LastData))
 		{
-			if (IsTargetDataValid(LastData))
+			if (DispatchIsTargetDataValid(LastData))
 			{
 				OnLostTarget();
 			}
@@ -105,13 +338,46 @@ void UGA_Passive_FindInteractableBase::TickFindInteractable()
 	}
 	else
 	{
-		if (IsTargetDataValid(LastData))
+		if (DispatchIsTargetDataValid(LastData))
 		{
 			OnLostTarget();
 		}
 	}
 
 	LastData = FoundData;
+
+	const FHitResult* FoundHit = GASXFindInteractable::GetFirstHitResult(FoundData);
+	WatchInteractable(FoundHit ? FoundHit->GetActor() : nullptr);
+}
+
+void UGA_Passive_FindInteractableBase::WatchInteractable(AActor* TargetActor)
+{
+	UGASXInteractableComponent* InteractableComponent = UGASXInteractableComponent::FindInteractableComponent(TargetActor);
+	if (InteractableComponent == WatchedInteractable.Get())
+	{
+		return;
+	}
+
+	if (UGASXInteractableComponent* OldInteractable = WatchedInteractable.Get())
+	{
+		OldInteractable->OnInteractableChanged.Remove(WatchedInteractableHandle);
+	}
+	WatchedInteractableHandle.Reset();
+	WatchedInteractable = InteractableComponent;
+
+	if (InteractableComponent)
+	{
+		WatchedInteractableHandle = InteractableComponent->OnInteractableChanged.AddUObject(this, &UGA_Passive_FindInteractableBase::OnWatchedInteractableChanged);
+	}
+}
+
+void UGA_Passive_FindInteractableBase::OnWatchedInteractableChanged(UGASXInteractableComponent* InteractableComponent)
+{
+	// e.g. the target became unavailable. Don't wait for the next scan to notice it.
+	if (IsActive())
+	{
+		RunInteractionScan();
+	}
 }
 
 void UGA_Passive_FindInteractableBase::OnFoundTarget(const FGameplayAbilityTargetDataHandle& FoundData)
@@ -122,6 +388,7 @@ void UGA_Passive_FindInteractableBase::OnFoundTarget(const FGameplayAbilityTarge
 		UE_LOG(LogGASX, Log, TEXT("%s"), *FString("Found target: " + MakeTargetDataMessage(FoundData)));
 	}
 #endif
+	GASX_INTERACTION_COUNT(TargetsFound, 1);
 
 	if (!bIsInteracting)
 	{
@@ -129,10 +396,9 @@ void UGA_Passive_FindInteractableBase::OnFoundTarget(const FGameplayAbilityTarge
 
 		// Notifies that target is found.
 		FGameplayEventData Payload;
-		Payload.EventTag = FoundInteractableTag;
 		Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
 		Payload.TargetData = CurrentTargetData;
-		SendGameplayEvent(Payload.EventTag, Payload);
+		SendGameplayEvents({ FoundInteractableTag }, Payload);
 	}
 }
 
@@ -144,6 +410,7 @@ void UGA_Passive_FindInteractableBase::OnLostTarget()
 		UE_LOG(LogGASX, Log, TEXT("%s"), *FString("Lost target: " + MakeTargetDataMessage(LastData)));
 	}
 #endif
+	GASX_INTERACTION_COUNT(TargetsLost, 1);
 
 	CancelWaiting(bBlockInteractionIfTargetWasLost);
 }
@@ -157,10 +424,9 @@ void UGA_Passive_FindInteractableBase::CancelWaiting(bool bCancelOngoingInteract
 
 	// Notifies that target is lost.
 	FGameplayEventData Payload;
-	Payload.EventTag = LostInteractableTag;
 	Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
 	Payload.TargetData = CurrentTargetData;
-	SendGameplayEvent(Payload.EventTag, Payload);
+	SendGameplayEvents({ LostInteractableTag }, Payload);
 
 	CurrentTargetData.Clear();
 }
@@ -169,7 +435,7 @@ void UGA_Passive_FindInteractableBase::InputPressed(const FGameplayAbilitySpecHa
 {
 	Super::InputPressed(Handle, ActorInfo, ActivationInfo);
 
-	if (!bIsInteractionBlocked && !bIsInteracting && IsTargetDataValid(CurrentTargetData) && ActorInfo != NULL && ActorInfo->AvatarActor != NULL)
+	if (!bIsInteractionBlocked && !bIsInteracting && DispatchIsTargetDataValid(CurrentTargetData) && ActorInfo != NULL && ActorInfo->AvatarActor != NULL)
 	{
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 		if (GASXConsoleVariables::DebugPassiveInteract)
@@ -182,19 +448,14 @@ void UGA_Passive_FindInteractableBase::InputPressed(const FGameplayAbilitySpecHa
 		InteractingTargetData = CurrentTargetData;
 
 		FHitResult HitResult = UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(InteractingTargetData, 0);
-		float Duration = IGASXInteractable::Execute_GetInteractionDuration(HitResult.GetActor(), HitResult.GetComponent());
+		float Duration = UGASXLibrary::GetInteractionDuration(HitResult.GetActor(), HitResult.GetComponent());
 
-		// Notifies interaction start.
+		// Notifies interaction start, then triggers interaction ability.
 		FGameplayEventData Payload;
-		Payload.EventTag = StartInteractionTag;
 		Payload.Instigator = ActorInfo->AvatarActor.Get();
 		Payload.TargetData = InteractingTargetData;
 		Payload.EventMagnitude = Duration; // Pass interaction duration
-		SendGameplayEvent(Payload.EventTag, Payload);
-
-		// Triggers interaction ability
-		Payload.EventTag = InteractionAbilityTag;
-		SendGameplayEvent(Payload.EventTag, Payload);
+		SendGameplayEvents({ StartInteractionTag, InteractionAbilityTag }, Payload);
 	}
 }
 
@@ -209,7 +470,7 @@ void UGA_Passive_FindInteractableBase::EndInteraction(bool bTryWaitAgain)
 {
 	if (CurrentActorInfo != NULL && CurrentActorInfo->AvatarActor != NULL)
 	{
-		bool bShouldEndInteraction = bIsInteracting && IsTargetDataValid(InteractingTargetData);
+		bool bShouldEndInteraction = bIsInteracting && DispatchIsTargetDataValid(InteractingTargetData);
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 		if (GASXConsoleVariables::DebugPassiveInteract)
@@ -227,15 +488,14 @@ void UGA_Passive_FindInteractableBase::EndInteraction(bool bTryWaitAgain)
 		{
 			// Notifies interaction end. This also stops ongoing interaction ability.
 			FGameplayEventData Payload;
-			Payload.EventTag = EndInteractionTag;
 			Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
 			Payload.TargetData = EndTargetData;
-			SendGameplayEvent(Payload.EventTag, Payload);
+			SendGameplayEvents({ EndInteractionTag }, Payload);
 
 			// This handles the case where interaction is finished by releasing the input but the current target is still the same. The owner might want to interact with the same target again.
 			if (bTryWaitAgain
 				&& !bIsInteractionBlocked
-				&& IsTargetDataValid(CurrentTargetData)
+				&& DispatchIsTargetDataValid(CurrentTargetData)
 				&& UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(CurrentTargetData, 0).GetActor() == UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(EndTargetData, 0).GetActor())
 			{
 				OnFoundTarget(EndTargetData);
@@ -246,46 +506,146 @@ void UGA_Passive_FindInteractableBase::EndInteraction(bool bTryWaitAgain)
 
 bool UGA_Passive_FindInteractableBase::TryFindTargetInteractable_Implementation(FGameplayAbilityTargetDataHandle& OutTargetDataHandle)
 {
-	float MinDistanceSpr = FLT_MAX;
-	bool bIsDataValid = false;
+	if (bUseInteractableRegistry)
+	{
+		return FindTargetFromRegistry(OutTargetDataHandle);
+	}
+
+	const AActor* Avatar = CurrentActorInfo ? CurrentActorInfo->AvatarActor.Get() : nullptr;
+	if (!Avatar)
+	{
+		return false;
+	}
 
-	TArray<FHitResult> Targets;
-	if (GetTargets(Targets))
+	const int32 OldMax = ScratchHitResults.Max();
+	ScratchHitResults.Reset();
+	if (!DispatchGetTargets(ScratchHitResults))
+	{
+		return false;
+	}
+	if (ScratchHitResults.Max() != OldMax)
 	{
-		for (auto T : Targets)
+		INC_DWORD_STAT(STAT_GASXInteractionScanBufferGrowths);
+	}
+	GASX_INTERACTION_COUNT(Candidates, ScratchHitResults.Num());
+
+	// The closest valid hit. Distance is checked first, as it's cheaper than validation.
+	const FVector AvatarLocation = Avatar->GetActorLocation();
+	float MinDistanceSqr = FLT_MAX;
+	const FHitResult* BestHit = nullptr;
+	for (const FHitResult& HitResult : ScratchHitResults)
+	{
+		const UPrimitiveComponent* Component = HitResult.GetComponent();
+		if (Component == nullptr)
 		{
-			FGameplayAbilityTargetDataHandle Data;
-			if (MakeValidTargetDataFromHitResult(T, Data))
-			{
-				if (T.GetComponent() != nullptr && CurrentActorInfo != nullptr && CurrentActorInfo->AvatarActor != nullptr)
-				{
-					float DistSqr = FVector::DistSquared(T.GetComponent()->GetComponentLocation(), CurrentActorInfo->AvatarActor->GetActorLocation());
-					if (DistSqr < MinDistanceSpr)
-					{
-						bIsDataValid = true;
-						MinDistanceSpr = DistSqr;
-						OutTargetDataHandle = Data;
-					}
-				}
-			}
+			continue;
+		}
+
+		const float DistSqr = FVector::DistSquared(Component->GetComponentLocation(), AvatarLocation);
+		if (DistSqr < MinDistanceSqr && IsHitResultValid(HitResult))
+		{
+			MinDistanceSqr = DistSqr;
+			BestHit = &HitResult;
 		}
 	}
-	return bIsDataValid;
+
+	if (BestHit == nullptr)
+	{
+		return false;
+	}
+
+	// Same target as last scan. Reuse its target data instead of making new one.
+	if (BestHit->GetComponent() == GASXFindInteractable::GetFirstHitComponent(LastData))
+	{
+		OutTargetDataHandle = LastData;
+		return true;
+	}
+
+	OutTargetDataHandle = UAbilitySystemBlueprintLibrary::AbilityTargetDataFromHitResult(*BestHit);
+	return true;
 }
 
 bool UGA_Passive_FindInteractableBase::GetTargets_Implementation(TArray<FHitResult>& OutHitResults)
 {
-	FGameplayEventData EventData;
-	TArray<AActor*> TargetActors;
 	const UGASXTargetType* TargetTypeCDO = TargetType.GetDefaultObject();
-	TargetTypeCDO->GetTargets(*CurrentActorInfo, EventData, OutHitResults, TargetActors);
+	if (!TargetTypeCDO || !CurrentActorInfo)
+	{
+		return false;
+	}
+
+	FGameplayEventData EventData;
+	ScratchActors.Reset();
+	GASX_INTERACTION_COUNT(Traces, 1);
+	TargetTypeCDO->DispatchGetTargets(*CurrentActorInfo, EventData, OutHitResults, ScratchActors);
 	return OutHitResults.Num() > 0;
 }
 
+bool UGA_Passive_FindInteractableBase::FindTargetFromRegistry(FGameplayAbilityTargetDataHandle& OutTargetDataHandle)
+{
+	const AActor* Avatar = CurrentActorInfo ? CurrentActorInfo->AvatarActor.Get() : nullptr;
+	UWorld* World = GetWorld();
+	UGASXInteractableRegistrySubsystem* Registry = World ? World->GetSubsystem<UGASXInteractableRegistrySubsystem>() : nullptr;
+	if (!Avatar || !Registry)
+	{
+		return false;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	Avatar->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+
+	// Every candidate in range is fetched, as unavailable ones don't use up line of sight traces.
+	const float CosHalfAngle = RegistryQueryHalfAngle >= 180.f ? -2.f : FMath::Cos(FMath::DegreesToRadians(RegistryQueryHalfAngle));
+	TArray<FGASXInteractableCandidate, TInlineAllocator<16>> Candidates;
+	Registry->FindNearestInteractables(ViewLocation, ViewRotation.Vector(), RegistryQueryRadius, CosHalfAngle, MAX_int32, Candidates);
+	GASX_INTERACTION_COUNT(Candidates, Candidates.Num());
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GASXInteractableLineOfSight), false, Avatar);
+	int32 NumTraces = 0;
+	for (const FGASXInteractableCandidate& Candidate : Candidates)
+	{
+		if (NumTraces >= MaxLineOfSightTraces)
+		{
+			break;
+		}
+
+		FHitResult HitResult(Candidate.Actor, Candidate.Component, Candidate.Location, (ViewLocation - Candidate.Location).GetSafeNormal());
+		HitResult.TraceStart = ViewLocation;
+		HitResult.TraceEnd = Candidate.Location;
+		HitResult.Distance = FMath::Sqrt(Candidate.DistanceSquared);
+		HitResult.bBlockingHit = true;
+
+		if (!IsHitResultValid(HitResult))
+		{
+			continue;
+		}
+
+		// In sight if nothing blocks the way, or the first thing in the way is the candidate itself.
+		FHitResult BlockingHit;
+		++NumTraces;
+		GASX_INTERACTION_COUNT(Traces, 1);
+		if (World->LineTraceSingleByChannel(BlockingHit, ViewLocation, Candidate.Location, LineOfSightChannel, QueryParams) && BlockingHit.GetActor() != Candidate.Actor)
+		{
+			continue;
+		}
+
+		// Same target as last scan. Reuse its target data instead of making new one.
+		if (Candidate.Component == GASXFindInteractable::GetFirstHitComponent(LastData))
+		{
+			OutTargetDataHandle = LastData;
+			return true;
+		}
+
+		OutTargetDataHandle = UAbilitySystemBlueprintLibrary::AbilityTargetDataFromHitResult(HitResult);
+		return true;
+	}
+	return false;
+}
+
 bool UGA_Passive_FindInteractableBase::MakeValidTargetDataFromHitResult(const FHitResult& InHitResult, FGameplayAbilityTargetDataHandle& OutValidTargetData)
 {
 	FGameplayAbilityTargetDataHandle Result = UAbilitySystemBlueprintLibrary::AbilityTargetDataFromHitResult(InHitResult);
-	if (IsTargetDataValid(Result))
+	if (DispatchIsTargetDataValid(Result))
 	{
 		OutValidTargetData = Result;
 		return true;
@@ -295,17 +655,17 @@ bool UGA_Passive_FindInteractableBase::MakeValidTargetDataFromHitResult(const FH
 
 bool UGA_Passive_FindInteractableBase::IsTargetDataValid_Implementation(const FGameplayAbilityTargetDataHandle& InTargetData)
 {
-	if (CurrentActorInfo != nullptr && CurrentActorInfo->AvatarActor != nullptr)
+	const FHitResult* HitResult = GASXFindInteractable::GetFirstHitResult(InTargetData);
+	if (HitResult != nullptr && CurrentActorInfo != nullptr && CurrentActorInfo->AvatarActor != nullptr)
 	{
-		TArray<AActor*> IgnoreActors = TArray<AActor*>{ CurrentActorInfo->AvatarActor.Get() };
-		return UGASXLibrary::IsTargetDataValidForInteraction(InTargetData, IgnoreActors, true);
+		return UGASXLibrary::IsHitResultValidForInteraction(*HitResult, CurrentActorInfo->AvatarActor.Get(), true);
 	}
 	return false;
 }
 
 FString UGA_Passive_FindInteractableBase::MakeTargetDataMessage(const FGameplayAbilityTargetDataHandle& InTargetDataHandle)
 {
-	if (IsTargetDataValid(InTargetDataHandle))
+	if (DispatchIsTargetDataValid(InTargetDataHandle))
 	{
 		return FString::Printf(TEXT("%s (%s)")
 			, *(UAbilitySystemBlueprintLibrary::GetHitResultFromTargetData(InTargetDataHandle, 0).GetComponent()->GetName())
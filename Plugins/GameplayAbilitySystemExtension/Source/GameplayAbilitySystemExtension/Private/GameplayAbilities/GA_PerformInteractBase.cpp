@@ -7,6 +7,7 @@
 #include "GASXMacroDefinitions.h"
 #include "Components/PrimitiveComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "Engine/World.h"
 
 namespace GASXConsoleVariables
 {
@@ -36,7 +37,11 @@ void UGA_PerformInteractBase::ActivateAbility(const FGameplayAbilitySpecHandle H
 			OnEndInteractionHandle = OwnerInfo->AbilitySystemComponent->GenericGameplayEventCallbacks.FindOrAdd(EndInteractionTag).AddUObject(this, &UGA_PerformInteractBase::OnEndInteractionEvent);
 		}
 
-		if (IsTargetDataValid(TriggerEventData->TargetData))
+		if (!ValidateClientTarget(TriggerEventData->TargetData))
+		{
+			FailReason = "Target data failed server validation";
+		}
+		else if (IsTargetDataValid(TriggerEventData->TargetData))
 		{
 			CurrentTargetData = TriggerEventData->TargetData;
 
@@ -54,16 +59,15 @@ void UGA_PerformInteractBase::ActivateAbility(const FGameplayAbilitySpecHandle H
 					ExecuteInteractableAbility(InteractablePreInteractTag);
 				}
 
-				float InteractionDuration = IGASXInteractable::Execute_GetInteractionDuration(InteractableActor, InteractableComponent);
+				float InteractionDuration = UGASXLibrary::GetInteractionDuration(InteractableActor, InteractableComponent);
 				if (InteractionDuration <= 0.f)
 				{
 					PerformMainInteraction();
 					return;
 				}
-				else if (UWorld* World = GetWorld())
+				else if (UGASXInteractionSubsystem* InteractionSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UGASXInteractionSubsystem>() : nullptr)
 				{
-					FTimerHandle TimerHandle_Delay;
-					World->GetTimerManager().SetTimer(TimerHandle_Delay, this, &UGA_PerformInteractBase::PerformMainInteraction, InteractionDuration, false);
+					InteractionHoldHandle = InteractionSubsystem->StartHold(InteractionDuration, FSimpleDelegate::CreateUObject(this, &UGA_PerformInteractBase::PerformMainInteraction), OwnerInfo->AvatarActor.Get());
 					return;
 				}
 				FailReason = "PerformMainInteraction is not executed for some reason";
@@ -97,7 +101,12 @@ void UGA_PerformInteractBase::EndAbility(const FGameplayAbilitySpecHandle Handle
 			ActorInfo->AbilitySystemComponent->GenericGameplayEventCallbacks.FindOrAdd(EndInteractionTag).Remove(OnEndInteractionHandle);
 		}
 
+		CancelInteractionHold();
+
 		if (bWasCancelled) CancelInteraction();
+
+		// Otherwise an activation which fails before setting a target would cancel the interaction with the previous target.
+		CurrentTargetData.Clear();
 	}
 
 	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
@@ -105,6 +114,9 @@ void UGA_PerformInteractBase::EndAbility(const FGameplayAbilitySpecHandle Handle
 
 void UGA_PerformInteractBase::PerformMainInteraction()
 {
+	// Completed, or called early from elsewhere.
+	CancelInteractionHold();
+
 	if (bIsInteracting)
 	{
 		AActor* InteractableActor = nullptr;
@@ -113,25 +125,20 @@ void UGA_PerformInteractBase::PerformMainInteraction()
 		{
 			IGASXInteractable::Execute_Interact(InteractableActor, CurrentActorInfo->AvatarActor.Get(), InteractableComponent);
 
+			FGameplayEventData Payload;
+			Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
+			Payload.TargetData = CurrentTargetData;
+
 			if (bShouldActivateAbilityOnPreInteract)
 			{
-				FGameplayEventData Payload;
-				Payload.EventTag = InteractableInteractTag;
-				Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
-				Payload.TargetData = CurrentTargetData;
-				SendGameplayEvent(Payload.EventTag, Payload);
+				SendGameplayEvents({ InteractableInteractTag, ExecuteInteractionTag }, Payload);
 			}
 			else
 			{
 				ExecuteInteractableAbility(InteractableInteractTag);
+				SendGameplayEvents({ ExecuteInteractionTag }, Payload);
 			}
 
-			FGameplayEventData Payload;
-			Payload.EventTag = ExecuteInteractionTag;
-			Payload.Instigator = CurrentActorInfo->AvatarActor.Get();
-			Payload.TargetData = CurrentTargetData;
-			SendGameplayEvent(Payload.EventTag, Payload);
-
 			bIsInteracting = false;
 			InteractableAbilityHandle = FGameplayAbilitySpecHandle();	// invalidate
 			EndAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo, true, false);
@@ -159,6 +166,26 @@ void UGA_PerformInteractBase::OnEndInteractionEvent(const FGameplayEventData* Pa
 	}
 }
 
+void UGA_PerformInteractBase::CancelInteractionHold()
+{
+	if (!InteractionHoldHandle.IsValid())
+	{
+		return;
+	}
+
+	if (UGASXInteractionSubsystem* InteractionSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UGASXInteractionSubsystem>() : nullptr)
+	{
+		InteractionSubsystem->CancelHold(InteractionHoldHandle);
+	}
+	InteractionHoldHandle.Invalidate();
+}
+
+float UGA_PerformInteractBase::GetInteractionHoldProgress() const
+{
+	const UGASXInteractionSubsystem* InteractionSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UGASXInteractionSubsystem>() : nullptr;
+	return InteractionSubsystem ? InteractionSubsystem->GetHoldProgress(InteractionHoldHandle) : -1.f;
+}
+
 bool UGA_PerformInteractBase::GetCurrentTargetInfo(AActor*& InteractableActor, UPrimitiveComponent*& InteractableComponent)
 {
 	if (UAbilitySystemBlueprintLibrary::TargetDataHasHitResult(CurrentTargetData, 0))
@@ -218,6 +245,58 @@ void UGA_PerformInteractBase::CancelInteraction()
 	}
 }
 
+bool UGA_PerformInteractBase::ValidateClientTarget(const FGameplayAbilityTargetDataHandle& InTargetData)
+{
+	if (!bValidateClientTarget || CurrentActorInfo == nullptr || !CurrentActorInfo->IsNetAuthority() || CurrentActorInfo->IsLocallyControlled())
+	{
+		return true;
+	}
+
+	const FGameplayAbilityTargetData* Data = InTargetData.Get(0);
+	const FHitResult* HitResult = Data ? Data->GetHitResult() : nullptr;
+	UPrimitiveComponent* Component = HitResult ? HitResult->GetComponent() : nullptr;
+	const AActor* Avatar = CurrentActorInfo->AvatarActor.Get();
+	UWorld* World = GetWorld();
+	if (!Component || !Avatar || !World)
+	{
+		return false;
+	}
+
+	const FVector AvatarLocation = Avatar->GetActorLocation();
+	const double Now = World->GetTimeSeconds();
+	if (Component == ValidatedComponent.Get()
+		&& Now - ValidatedTime <= ValidationCacheTime
+		&& FVector::DistSquared(AvatarLocation, ValidatedAvatarLocation) <= FMath::Square(ValidationCacheTolerance))
+	{
+		return bLastValidationResult;
+	}
+
+	bool bValid = Component->Bounds.GetBox().ComputeSquaredDistanceToPoint(AvatarLocation) <= FMath::Square(MaxInteractionDistance);
+	if (bValid && bRequireLineOfSight)
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Avatar->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+
+		FHitResult BlockingHit;
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GASXValidateInteractionTarget), false, Avatar);
+		bValid = !World->LineTraceSingleByChannel(BlockingHit, ViewLocation, Component->Bounds.Origin, LineOfSightChannel, QueryParams) || BlockingHit.GetActor() == Component->GetOwner();
+	}
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (!bValid && GASXConsoleVariables::DebugInteract)
+	{
+		UE_LOG(LogGASX, Warning, TEXT("Rejected interaction target %s of %s: out of range or not in sight."), *Component->GetName(), *GetNameSafe(Avatar));
+	}
+#endif
+
+	ValidatedComponent = Component;
+	ValidatedAvatarLocation = AvatarLocation;
+	ValidatedTime = Now;
+	bLastValidationResult = bValid;
+	return bValid;
+}
+
 bool UGA_PerformInteractBase::IsTargetDataValid_Implementation(const FGameplayAbilityTargetDataHandle& InTargetData)
 {
 	if (CurrentActorInfo != nullptr && CurrentActorInfo->AvatarActor != nullptr)
@@ -0,0 +1,195 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "GameplayEffects/GASXAreaEffectComponent.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Components/ShapeComponent.h"
+#include "GameplayEffect.h"
+#include "GASXMacroDefinitions.h"
+
+UGASXAreaEffectComponent::UGASXAreaEffectComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UGASXAreaEffectComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* Owner = GetOwner();
+	if (!Owner || !Owner->HasAuthority())
+	{
+		return;
+	}
+
+	TInlineComponentArray<UShapeComponent*> Shapes(Owner);
+	for (UShapeComponent* Shape : Shapes)
+	{
+		if (ShapeComponentName.IsNone() || Shape->GetFName() == ShapeComponentName)
+		{
+			ShapeComponent = Shape;
+			break;
+		}
+	}
+
+	UShapeComponent* Shape = ShapeComponent.Get();
+	if (!Shape)
+	{
+		UE_LOG(LogGASX, Warning, TEXT("%s: No shape component %s found on %s."), *GetName(), *ShapeComponentName.ToString(), *Owner->GetName());
+		return;
+	}
+
+	BuildEffectSpecs();
+
+	Shape->OnComponentBeginOverlap.AddDynamic(this, &UGASXAreaEffectComponent::OnShapeBeginOverlap);
+	Shape->OnComponentEndOverlap.AddDynamic(this, &UGASXAreaEffectComponent::OnShapeEndOverlap);
+
+	// Whatever is already inside doesn't get a begin overlap event.
+	TArray<UPrimitiveComponent*> OverlappingComponents;
+	Shape->GetOverlappingComponents(OverlappingComponents);
+	for (UPrimitiveComponent* OverlappingComponent : OverlappingComponents)
+	{
+		OnShapeBeginOverlap(Shape, OverlappingComponent->GetOwner(), OverlappingComponent, INDEX_NONE, false, FHitResult());
+	}
+}
+
+void UGASXAreaEffectComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShapeComponent* Shape = ShapeComponent.Get())
+	{
+		Shape->OnComponentBeginOverlap.RemoveDynamic(this, &UGASXAreaEffectComponent::OnShapeBeginOverlap);
+		Shape->OnComponentEndOverlap.RemoveDynamic(this, &UGASXAreaEffectComponent::OnShapeEndOverlap);
+	}
+
+	if (bRemoveEffectsOnExit)
+	{
+		for (TPair<TObjectKey<AActor>, FTarget>& Pair : Targets)
+		{
+			RemoveEffects(Pair.Value);
+		}
+	}
+	Targets.Reset();
+	EffectSpecs.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGASXAreaEffectComponent::RefreshEffects()
+{
+	if (!ShapeComponent.IsValid())
+	{
+		return;
+	}
+
+	BuildEffectSpecs();
+	for (TPair<TObjectKey<AActor>, FTarget>& Pair : Targets)
+	{
+		RemoveEffects(Pair.Value);
+		ApplyEffects(Pair.Value);
+	}
+}
+
+void UGASXAreaEffectComponent::OnShapeBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!OtherActor || !OtherComp)
+	{
+		return;
+	}
+
+	if (FTarget* Target = Targets.Find(OtherActor))
+	{
+		Target->OverlappingComponents.AddUnique(OtherComp);
+		return;
+	}
+
+	UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(OtherActor);
+	if (!ASC || !CanAffect(OtherActor, ASC))
+	{
+		return;
+	}
+
+	FTarget& Target = Targets.Add(OtherActor);
+	Target.AbilitySystemComponent = ASC;
+	Target.OverlappingComponents.Add(OtherComp);
+	ApplyEffects(Target);
+}
+
+void UGASXAreaEffectComponent::OnShapeEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	FTarget* Target = Targets.Find(OtherActor);
+	if (!Target)
+	{
+		return;
+	}
+
+	Target->OverlappingComponents.RemoveAllSwap([OtherComp](const TWeakObjectPtr<UPrimitiveComponent>& Component) { return !Component.IsValid() || Component == OtherComp; }, EAllowShrinking::No);
+	if (Target->OverlappingComponents.IsEmpty())
+	{
+		if (bRemoveEffectsOnExit)
+		{
+			RemoveEffects(*Target);
+		}
+		Targets.Remove(OtherActor);
+	}
+}
+
+void UGASXAreaEffectComponent::BuildEffectSpecs()
+{
+	EffectSpecs.Reset();
+
+	AActor* Owner = GetOwner();
+	FGameplayEffectContextHandle Context(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+	Context.AddInstigator(Owner->GetInstigator() ? Owner->GetInstigator() : Owner, Owner);
+	Context.AddSourceObject(this);
+
+	for (const TSubclassOf<UGameplayEffect>& EffectClass : EffectContainer.TargetGameplayEffectClasses)
+	{
+		if (EffectClass)
+		{
+			EffectSpecs.Emplace(new FGameplayEffectSpec(EffectClass->GetDefaultObject<UGameplayEffect>(), Context, EffectLevel));
+		}
+	}
+}
+
+void UGASXAreaEffectComponent::ApplyEffects(FTarget& Target)
+{
+	UAbilitySystemComponent* ASC = Target.AbilitySystemComponent.Get();
+	if (!ASC)
+	{
+		return;
+	}
+
+	for (const FGameplayEffectSpecHandle& Spec : EffectSpecs)
+	{
+		// Instant effects return an invalid handle, and there's nothing to remove for them.
+		const FActiveGameplayEffectHandle Handle = ASC->ApplyGameplayEffectSpecToSelf(*Spec.Data.Get());
+		if (Handle.IsValid())
+		{
+			Target.EffectHandles.Add(Handle);
+		}
+	}
+}
+
+void UGASXAreaEffectComponent::RemoveEffects(FTarget& Target)
+{
+	if (UAbilitySystemComponent* ASC = Target.AbilitySystemComponent.Get())
+	{
+		for (const FActiveGameplayEffectHandle& Handle : Target.EffectHandles)
+		{
+			ASC->RemoveActiveGameplayEffect(Handle);
+		}
+	}
+	Target.EffectHandles.Reset();
+}
+
+bool UGASXAreaEffectComponent::CanAffect(const AActor* Actor, const UAbilitySystemComponent* AbilitySystemComponent) const
+{
+	const AActor* Owner = GetOwner();
+	if (!bAffectOwner
+		&& (Actor == Owner || Actor == Owner->GetInstigator() || AbilitySystemComponent == UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Owner)))
+	{
+		return false;
+	}
+	return TargetTagRequirements.RequirementsMet(AbilitySystemComponent->GetOwnedGameplayTags());
+}
@@ -0,0 +1,24 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "GameplayEffects/GASXAreaEffectZone.h"
+#include "GameplayEffects/GASXAreaEffectComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/CollisionProfile.h"
+
+AGASXAreaEffectZone::AGASXAreaEffectZone(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	AreaComponent = CreateDefaultSubobject<USphereComponent>(TEXT("AreaComponent"));
+	AreaComponent->InitSphereRadius(300.f);
+	AreaComponent->SetCollisionProfileName(UCollisionProfile::CustomCollisionProfileName);
+	AreaComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	AreaComponent->SetCollisionResponseToAllChannels(ECR_Ignore);
+	AreaComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	AreaComponent->SetGenerateOverlapEvents(true);
+	RootComponent = AreaComponent;
+
+	AreaEffectComponent = CreateDefaultSubobject<UGASXAreaEffectComponent>(TEXT("AreaEffectComponent"));
+	AreaEffectComponent->ShapeComponentName = TEXT("AreaComponent");
+}
@@ -0,0 +1,53 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Interaction/GASXInteractableComponent.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+UGASXInteractableComponent::UGASXInteractableComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UGASXInteractableComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UGASXInteractableComponent, bAvailableForInteraction, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UGASXInteractableComponent, InteractionDuration, Params);
+}
+
+UGASXInteractableComponent* UGASXInteractableComponent::FindInteractableComponent(const AActor* Actor)
+{
+	return Actor ? Actor->FindComponentByClass<UGASXInteractableComponent>() : nullptr;
+}
+
+void UGASXInteractableComponent::SetAvailableForInteraction(bool bAvailable)
+{
+	if (bAvailableForInteraction != bAvailable)
+	{
+		bAvailableForInteraction = bAvailable;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UGASXInteractableComponent, bAvailableForInteraction, this);
+		OnInteractableChanged.Broadcast(this);
+	}
+}
+
+void UGASXInteractableComponent::SetInteractionDuration(float Duration)
+{
+	if (InteractionDuration != Duration)
+	{
+		InteractionDuration = Duration;
+		MARK_PROPERTY_DIRTY_FROM_NAME(UGASXInteractableComponent, InteractionDuration, this);
+		OnInteractableChanged.Broadcast(this);
+	}
+}
+
+void UGASXInteractableComponent::OnRep_InteractionState()
+{
+	OnInteractableChanged.Broadcast(this);
+}
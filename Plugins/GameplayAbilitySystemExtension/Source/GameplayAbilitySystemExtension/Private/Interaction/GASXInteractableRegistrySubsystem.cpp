@@ -0,0 +1,316 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Interaction/GASXInteractableRegistrySubsystem.h"
+#include "Interfaces/GASXInteractable.h"
+#include "GASXMacroDefinitions.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Movable Interactables"), STAT_GASXUpdateMovableInteractables, STATGROUP_GASXInteraction);
+DECLARE_CYCLE_STAT(TEXT("Interactable Registry Query"), STAT_GASXInteractableRegistryQuery, STATGROUP_GASXInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Registered Interactables"), STAT_GASXRegisteredInteractables, STATGROUP_GASXInteraction);
+
+namespace GASXConsoleVariables
+{
+	static float InteractableRegistryCellSize = 500.f;
+	static FAutoConsoleVariableRef CVarInteractableRegistryCellSize(
+		TEXT("gasx.interaction.RegistryCellSize"),
+		InteractableRegistryCellSize,
+		TEXT("Cell size of the interactable registry grid. Only read when the world begins play."),
+		ECVF_Default);
+}
+
+namespace GASXInteractableRegistry
+{
+	static float CellSize = 500.f;
+}
+
+bool UGASXInteractableRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGASXInteractableRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UGASXInteractableRegistrySubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UGASXInteractableRegistrySubsystem::OnLevelRemoved);
+}
+
+void UGASXInteractableRegistrySubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UGASXInteractableRegistrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	GASXInteractableRegistry::CellSize = FMath::Max(GASXConsoleVariables::InteractableRegistryCellSize, 1.f);
+
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		RegisterLevel(Level);
+	}
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UGASXInteractableRegistrySubsystem::OnActorSpawned));
+	ActorDestroyedHandle = InWorld.AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UGASXInteractableRegistrySubsystem::OnActorDestroyed));
+}
+
+void UGASXInteractableRegistrySubsystem::RegisterLevel(ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor && Actor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+		{
+			RegisterInteractable(Actor);
+		}
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+	{
+		RegisterInteractable(Actor);
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::OnActorDestroyed(AActor* Actor)
+{
+	UnregisterInteractable(Actor);
+}
+
+void UGASXInteractableRegistrySubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld() && World->HasBegunPlay())
+	{
+		RegisterLevel(Level);
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// A null level means all levels are removed.
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		const AActor* Actor = It->Actor.Get();
+		if (!Actor || !Level || Actor->GetLevel() == Level)
+		{
+			RemoveEntry(It.GetIndex());
+		}
+	}
+}
+
+FIntVector UGASXInteractableRegistrySubsystem::GetCell(const FVector& Location) const
+{
+	const FVector Scaled = Location / GASXInteractableRegistry::CellSize;
+	return FIntVector(FMath::FloorToInt(Scaled.X), FMath::FloorToInt(Scaled.Y), FMath::FloorToInt(Scaled.Z));
+}
+
+void UGASXInteractableRegistrySubsystem::AddToCell(int32 EntryIndex)
+{
+	Cells.FindOrAdd(Entries[EntryIndex].Cell).Add(EntryIndex);
+}
+
+void UGASXInteractableRegistrySubsystem::RemoveFromCell(int32 EntryIndex)
+{
+	const FIntVector Cell = Entries[EntryIndex].Cell;
+	if (auto* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (CellEntries->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::RegisterInteractable(AActor* Actor, UPrimitiveComponent* Component)
+{
+	if (!Actor || EntryByActor.Contains(Actor) || !Actor->GetClass()->ImplementsInterface(UGASXInteractable::StaticClass()))
+	{
+		return;
+	}
+
+	if (!Component)
+	{
+		Component = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	}
+	if (!Component)
+	{
+		Component = Actor->FindComponentByClass<UPrimitiveComponent>();
+	}
+	if (!Component)
+	{
+		return;
+	}
+
+	FEntry Entry;
+	Entry.Actor = Actor;
+	Entry.ActorKey = Actor;
+	Entry.Component = Component;
+	Entry.Location = Component->Bounds.Origin;
+	Entry.Cell = GetCell(Entry.Location);
+	Entry.bMovable = Component->Mobility == EComponentMobility::Movable;
+
+	const int32 EntryIndex = Entries.Add(Entry);
+	EntryByActor.Add(Actor, EntryIndex);
+	AddToCell(EntryIndex);
+	if (Entry.bMovable)
+	{
+		MovableEntries.Add(EntryIndex);
+	}
+
+	SET_DWORD_STAT(STAT_GASXRegisteredInteractables, Entries.Num());
+}
+
+void UGASXInteractableRegistrySubsystem::UnregisterInteractable(AActor* Actor)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (Actor && EntryByActor.RemoveAndCopyValue(Actor, EntryIndex))
+	{
+		RemoveEntry(EntryIndex);
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::RemoveEntry(int32 EntryIndex)
+{
+	FEntry& Entry = Entries[EntryIndex];
+	EntryByActor.Remove(Entry.ActorKey);
+	if (Entry.bMovable)
+	{
+		MovableEntries.RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+	}
+
+	RemoveFromCell(EntryIndex);
+	Entries.RemoveAt(EntryIndex);
+
+	SET_DWORD_STAT(STAT_GASXRegisteredInteractables, Entries.Num());
+}
+
+void UGASXInteractableRegistrySubsystem::UpdateMovableEntries()
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastUpdateFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXUpdateMovableInteractables);
+
+	for (int32 Index = MovableEntries.Num() - 1; Index >= 0; --Index)
+	{
+		const int32 EntryIndex = MovableEntries[Index];
+		FEntry& Entry = Entries[EntryIndex];
+		const UPrimitiveComponent* Component = Entry.Component.Get();
+		if (!Component)
+		{
+			// Destroyed without going through OnActorDestroyed, e.g. only the component was destroyed.
+			RemoveEntry(EntryIndex);
+			continue;
+		}
+
+		Entry.Location = Component->Bounds.Origin;
+		const FIntVector NewCell = GetCell(Entry.Location);
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(EntryIndex);
+			Entry.Cell = NewCell;
+			AddToCell(EntryIndex);
+		}
+	}
+}
+
+void UGASXInteractableRegistrySubsystem::GatherNearestInteractables(const FVector& Origin, const FVector& Direction, float Radius, float CosHalfAngle, int32 MaxCandidates)
+{
+	QueryCandidates.Reset();
+	if (MaxCandidates <= 0)
+	{
+		return;
+	}
+
+	UpdateMovableEntries();
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXInteractableRegistryQuery);
+
+	const float RadiusSquared = FMath::Square(Radius);
+	const bool bUseCone = CosHalfAngle > -1.f;
+	const FIntVector MinCell = GetCell(Origin - FVector(Radius));
+	const FIntVector MaxCell = GetCell(Origin + FVector(Radius));
+
+	// Max heap on distance, so that the farthest of the kept candidates is dropped first.
+	const auto FartherFirst = [](const FGASXInteractableCandidate& A, const FGASXInteractableCandidate& B) { return A.DistanceSquared > B.DistanceSquared; };
+	TArray<FGASXInteractableCandidate>& Heap = QueryCandidates;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const auto* CellEntries = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellEntries)
+				{
+					continue;
+				}
+
+				for (const int32 EntryIndex : *CellEntries)
+				{
+					const FEntry& Entry = Entries[EntryIndex];
+					const FVector ToEntry = Entry.Location - Origin;
+					const float DistanceSquared = (float)ToEntry.SizeSquared();
+					if (DistanceSquared > RadiusSquared)
+					{
+						continue;
+					}
+					if (bUseCone && (float)(ToEntry | Direction) < CosHalfAngle * FMath::Sqrt(DistanceSquared))
+					{
+						continue;
+					}
+					if (Heap.Num() == MaxCandidates && DistanceSquared >= Heap.HeapTop().DistanceSquared)
+					{
+						continue;
+					}
+
+					AActor* Actor = Entry.Actor.Get();
+					UPrimitiveComponent* Component = Entry.Component.Get();
+					if (!Actor || !Component)
+					{
+						continue;
+					}
+
+					if (Heap.Num() == MaxCandidates)
+					{
+						Heap.HeapPopDiscard(FartherFirst, EAllowShrinking::No);
+					}
+					Heap.HeapPush(FGASXInteractableCandidate{ Actor, Component, Entry.Location, DistanceSquared }, FartherFirst);
+				}
+			}
+		}
+	}
+
+	// Nearest first
+	Heap.Sort([](const FGASXInteractableCandidate& A, const FGASXInteractableCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+}
@@ -0,0 +1,368 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Interaction/GASXInteractionSubsystem.h"
+#include "GameplayAbilities/GA_Passive_FindInteractableBase.h"
+#include "GASXMacroDefinitions.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Interaction Scans"), STAT_GASXInteractionScans, STATGROUP_GASXInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Scanners"), STAT_GASXInteractionScanners, STATGROUP_GASXInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Scans Run"), STAT_GASXInteractionScansRun, STATGROUP_GASXInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Scans Overdue"), STAT_GASXInteractionScansOverdue, STATGROUP_GASXInteraction);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Interaction Max Lateness (ms)"), STAT_GASXInteractionMaxLateness, STATGROUP_GASXInteraction);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Interaction Avg Scan Time (us)"), STAT_GASXInteractionAvgScanTime, STATGROUP_GASXInteraction);
+DECLARE_CYCLE_STAT(TEXT("Interaction Holds"), STAT_GASXInteractionHolds, STATGROUP_GASXInteraction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interaction Running Holds"), STAT_GASXInteractionRunningHolds, STATGROUP_GASXInteraction);
+
+namespace GASXInteractionHolds
+{
+	// Wheel resolution in seconds. Holds still complete on the first frame past their end time, this only decides how they are grouped.
+	static constexpr double TickSeconds = 1.0 / 30.0;
+	static constexpr int32 NumSlots = 256;
+
+	static int64 ToTick(double Time)
+	{
+		return (int64)FMath::FloorToDouble(Time / TickSeconds);
+	}
+}
+
+namespace GASXConsoleVariables
+{
+	static float InteractionScanBudgetUs = 500.f;
+	static FAutoConsoleVariableRef CVarInteractionScanBudgetUs(
+		TEXT("gasx.interaction.ScanBudgetUs"),
+		InteractionScanBudgetUs,
+		TEXT("Time budget in microseconds for interaction scans per frame. At least one scan runs every frame regardless."),
+		ECVF_Default);
+
+	static float InteractionMovedDistance = 10.f;
+	static FAutoConsoleVariableRef CVarInteractionMovedDistance(
+		TEXT("gasx.interaction.MovedDistance"),
+		InteractionMovedDistance,
+		TEXT("Avatars that moved further than this since their last scan are scanned before idle ones."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdInteractionReport(
+		TEXT("gasx.interaction.Report"),
+		TEXT("Logs the interaction scanners that spent the most time scanning. Usage: gasx.interaction.Report [NumScanners=10]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+			{
+				const UGASXInteractionSubsystem* InteractionSubsystem = World ? World->GetSubsystem<UGASXInteractionSubsystem>() : nullptr;
+				if (!InteractionSubsystem)
+				{
+					UE_LOG(LogGASX, Warning, TEXT("gasx.interaction.Report: No interaction subsystem in this world."));
+					return;
+				}
+				InteractionSubsystem->LogCostliestScanners(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10);
+			}));
+}
+
+bool UGASXInteractionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UGASXInteractionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGASXInteractionSubsystem, STATGROUP_Tickables);
+}
+
+void UGASXInteractionSubsystem::RegisterScanner(UGA_Passive_FindInteractableBase* Ability)
+{
+	if (!Ability || Scanners.ContainsByPredicate([Ability](const FScanner& Scanner) { return Scanner.Ability == Ability; }))
+	{
+		return;
+	}
+
+	// Random phase, so that scanners registered on the same frame don't scan on the same frames.
+	FScanner& Scanner = Scanners.AddDefaulted_GetRef();
+	Scanner.Ability = Ability;
+	Scanner.NextScanTime = GetWorld()->GetTimeSeconds() + Ability->GetScanPeriod() * FMath::FRand();
+}
+
+void UGASXInteractionSubsystem::UnregisterScanner(UGA_Passive_FindInteractableBase* Ability)
+{
+	const int32 Index = Scanners.IndexOfByPredicate([Ability](const FScanner& Scanner) { return Scanner.Ability == Ability; });
+	if (Index != INDEX_NONE)
+	{
+		// Indices must stay stable while scanning. The entry is removed next frame.
+		if (bIsScanning)
+		{
+			Scanners[Index].Ability.Reset();
+		}
+		else
+		{
+			Scanners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	ScanCosts.Remove(Ability);
+}
+
+void UGASXInteractionSubsystem::RecordScan(const UGA_Passive_FindInteractableBase* Ability, double Seconds, bool bSkipped)
+{
+	FScanCost& Cost = ScanCosts.FindOrAdd(Ability);
+	if (!Cost.Avatar.IsValid())
+	{
+		Cost.Avatar = Ability->GetAvatarActorFromActorInfo();
+	}
+
+	if (bSkipped)
+	{
+		++Cost.NumSkipped;
+	}
+	else
+	{
+		++Cost.NumScans;
+		++FrameNumScans;
+	}
+	Cost.TotalSeconds += Seconds;
+	Cost.MaxSeconds = FMath::Max(Cost.MaxSeconds, Seconds);
+	FrameScanSeconds += Seconds;
+}
+
+void UGASXInteractionSubsystem::LogCostliestScanners(int32 NumScanners) const
+{
+	TArray<const FScanCost*> Sorted;
+	Sorted.Reserve(ScanCosts.Num());
+	for (const TPair<TObjectKey<UGA_Passive_FindInteractableBase>, FScanCost>& Pair : ScanCosts)
+	{
+		Sorted.Add(&Pair.Value);
+	}
+	Sorted.Sort([](const FScanCost& A, const FScanCost& B) { return A.TotalSeconds > B.TotalSeconds; });
+
+	UE_LOG(LogGASX, Display, TEXT("Interaction scanners: %d, overdue scans last frame: %d, max lateness: %.2f ms"), ScanCosts.Num(), NumOverdueScans, MaxScanLateness * 1000.f);
+	for (int32 Index = 0; Index < FMath::Min(NumScanners, Sorted.Num()); ++Index)
+	{
+		const FScanCost& Cost = *Sorted[Index];
+		const int32 NumRuns = Cost.NumScans + Cost.NumSkipped;
+		UE_LOG(LogGASX, Display, TEXT("  %-32s total %8.3f ms, scans %6d, skipped %6d, avg %7.2f us, max %7.2f us"),
+			*GetNameSafe(Cost.Avatar.Get()),
+			Cost.TotalSeconds * 1000.0,
+			Cost.NumScans,
+			Cost.NumSkipped,
+			NumRuns > 0 ? Cost.TotalSeconds * 1e6 / NumRuns : 0.0,
+			Cost.MaxSeconds * 1e6);
+	}
+}
+
+float UGASXInteractionSubsystem::GetScanPriority(const FScanner& Scanner, double Now) const
+{
+	const UGA_Passive_FindInteractableBase* Ability = Scanner.Ability.Get();
+	const FGameplayAbilityActorInfo* ActorInfo = Ability->GetCurrentActorInfo();
+	const AActor* Avatar = ActorInfo ? ActorInfo->AvatarActor.Get() : nullptr;
+
+	// Lateness breaks ties within a class
+	float Priority = (float)(Now - Scanner.NextScanTime);
+	if (ActorInfo && ActorInfo->IsLocallyControlled())
+	{
+		Priority += 2000.f;
+	}
+	if (Avatar && FVector::DistSquared(Avatar->GetActorLocation(), Scanner.LastScanLocation) > FMath::Square(GASXConsoleVariables::InteractionMovedDistance))
+	{
+		Priority += 1000.f;
+	}
+	return Priority;
+}
+
+FGASXInteractionHoldHandle UGASXInteractionSubsystem::StartHold(float Duration, FSimpleDelegate&& OnCompleted, const AActor* Instigator)
+{
+	if (HoldWheel.Num() == 0)
+	{
+		HoldWheel.SetNum(GASXInteractionHolds::NumSlots);
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (LastHoldTick == INDEX_NONE)
+	{
+		LastHoldTick = GASXInteractionHolds::ToTick(Now) - 1;
+	}
+
+	FHold Hold;
+	Hold.OnCompleted = MoveTemp(OnCompleted);
+	Hold.Instigator = Instigator;
+	Hold.StartTime = Now;
+	Hold.EndTime = Now + FMath::Max(Duration, 0.f);
+	Hold.EndTick = FMath::Max(GASXInteractionHolds::ToTick(Hold.EndTime), LastHoldTick + 1);
+	Hold.Serial = NextHoldSerial++;
+
+	FGASXInteractionHoldHandle Handle;
+	Handle.Serial = Hold.Serial;
+	Handle.Index = Holds.Add(MoveTemp(Hold));
+	HoldWheel[Holds[Handle.Index].EndTick % GASXInteractionHolds::NumSlots].Add(Handle);
+	return Handle;
+}
+
+void UGASXInteractionSubsystem::CancelHold(FGASXInteractionHoldHandle& Handle)
+{
+	// The wheel entry goes stale and is dropped when its slot comes around.
+	if (FindHold(Handle))
+	{
+		Holds.RemoveAt(Handle.Index);
+	}
+	Handle.Invalidate();
+}
+
+float UGASXInteractionSubsystem::GetHoldProgress(const FGASXInteractionHoldHandle& Handle) const
+{
+	const FHold* Hold = FindHold(Handle);
+	if (!Hold)
+	{
+		return -1.f;
+	}
+
+	const double Duration = Hold->EndTime - Hold->StartTime;
+	return Duration > 0.0 ? FMath::Clamp((float)((GetWorld()->GetTimeSeconds() - Hold->StartTime) / Duration), 0.f, 1.f) : 1.f;
+}
+
+const UGASXInteractionSubsystem::FHold* UGASXInteractionSubsystem::FindHold(const FGASXInteractionHoldHandle& Handle) const
+{
+	return Handle.IsValid() && Holds.IsValidIndex(Handle.Index) && Holds[Handle.Index].Serial == Handle.Serial ? &Holds[Handle.Index] : nullptr;
+}
+
+void UGASXInteractionSubsystem::TickHolds(double Now)
+{
+	if (Holds.Num() == 0)
+	{
+		// Nothing in the wheel but stale entries, which can be dropped all at once.
+		if (LastHoldTick != INDEX_NONE)
+		{
+			for (TArray<FGASXInteractionHoldHandle>& Slot : HoldWheel)
+			{
+				Slot.Reset();
+			}
+			LastHoldTick = INDEX_NONE;
+		}
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXInteractionHolds);
+
+	// Completions run after the wheel is updated, as they may start or cancel holds.
+	CompletedHolds.Reset();
+	const int64 CurrentTick = GASXInteractionHolds::ToTick(Now);
+	const int64 LastTick = FMath::Min(CurrentTick, LastHoldTick + GASXInteractionHolds::NumSlots);
+	for (int64 Tick = LastHoldTick + 1; Tick <= LastTick; ++Tick)
+	{
+		TArray<FGASXInteractionHoldHandle>& Slot = HoldWheel[Tick % GASXInteractionHolds::NumSlots];
+		for (int32 EntryIndex = Slot.Num() - 1; EntryIndex >= 0; --EntryIndex)
+		{
+			const FGASXInteractionHoldHandle& Entry = Slot[EntryIndex];
+			const FHold* Hold = FindHold(Entry);
+			if (!Hold)
+			{
+				Slot.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+			}
+			else if (Hold->EndTime <= Now)
+			{
+				CompletedHolds.Add(Hold->OnCompleted);
+				Holds.RemoveAt(Entry.Index);
+				Slot.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+			}
+		}
+	}
+	LastHoldTick = CurrentTick - 1;
+
+	SET_DWORD_STAT(STAT_GASXInteractionRunningHolds, Holds.Num());
+
+	if (OnHoldProgress.IsBound() && Holds.Num() > 0)
+	{
+		HoldProgress.Reset();
+		for (auto It = Holds.CreateConstIterator(); It; ++It)
+		{
+			FGASXInteractionHoldProgress& Progress = HoldProgress.AddDefaulted_GetRef();
+			Progress.Handle.Index = It.GetIndex();
+			Progress.Handle.Serial = It->Serial;
+			Progress.Instigator = It->Instigator;
+			const double Duration = It->EndTime - It->StartTime;
+			Progress.Progress = Duration > 0.0 ? FMath::Clamp((float)((Now - It->StartTime) / Duration), 0.f, 1.f) : 1.f;
+		}
+		OnHoldProgress.Broadcast(HoldProgress);
+	}
+
+	for (FSimpleDelegate& OnCompleted : CompletedHolds)
+	{
+		OnCompleted.ExecuteIfBound();
+	}
+	CompletedHolds.Reset();
+}
+
+void UGASXInteractionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	TickHolds(Now);
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXInteractionScans);
+
+	DueScanners.Reset();
+	for (int32 Index = Scanners.Num() - 1; Index >= 0; --Index)
+	{
+		const FScanner& Scanner = Scanners[Index];
+		if (!Scanner.Ability.IsValid())
+		{
+			Scanners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+		if (Scanner.NextScanTime <= Now)
+		{
+			DueScanners.Emplace(GetScanPriority(Scanner, Now), Index);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GASXInteractionScanners, Scanners.Num());
+
+	if (DueScanners.Num() > 1)
+	{
+		DueScanners.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	const double BudgetSeconds = GASXConsoleVariables::InteractionScanBudgetUs * 1e-6;
+	int32 NumScans = 0;
+	TGuardValue<bool> ScanningGuard(bIsScanning, true);
+	for (; NumScans < DueScanners.Num(); ++NumScans)
+	{
+		if (NumScans > 0 && FPlatformTime::Seconds() - StartSeconds > BudgetSeconds)
+		{
+			break;
+		}
+
+		FScanner& Scanner = Scanners[DueScanners[NumScans].Value];
+		UGA_Passive_FindInteractableBase* Ability = Scanner.Ability.Get();
+		if (!Ability)
+		{
+			continue;
+		}
+
+		// Keep the rhythm of the scanner, but never schedule into the past.
+		Scanner.NextScanTime = FMath::Max(Scanner.NextScanTime + Ability->GetScanPeriod(), Now);
+		if (const AActor* Avatar = Ability->GetAvatarActorFromActorInfo())
+		{
+			Scanner.LastScanLocation = Avatar->GetActorLocation();
+		}
+
+		Ability->RunInteractionScan();
+	}
+
+	NumOverdueScans = DueScanners.Num() - NumScans;
+	MaxScanLateness = 0.f;
+	for (int32 Index = NumScans; Index < DueScanners.Num(); ++Index)
+	{
+		MaxScanLateness = FMath::Max(MaxScanLateness, (float)(Now - Scanners[DueScanners[Index].Value].NextScanTime));
+	}
+
+	SET_DWORD_STAT(STAT_GASXInteractionScansRun, NumScans);
+	SET_DWORD_STAT(STAT_GASXInteractionScansOverdue, NumOverdueScans);
+	SET_FLOAT_STAT(STAT_GASXInteractionMaxLateness, MaxScanLateness * 1000.f);
+
+	// Includes scans run by timers since last Tick.
+	const float AvgScanTimeUs = FrameNumScans > 0 ? (float)(FrameScanSeconds * 1e6 / FrameNumScans) : 0.f;
+	SET_FLOAT_STAT(STAT_GASXInteractionAvgScanTime, AvgScanTimeUs);
+	CSV_CUSTOM_STAT(GASXInteraction, Scanners, Scanners.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GASXInteraction, ScansOverdue, NumOverdueScans, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GASXInteraction, AvgScanTimeUs, AvgScanTimeUs, ECsvCustomStatOp::Set);
+	FrameScanSeconds = 0.0;
+	FrameNumScans = 0;
+}
@@ -0,0 +1,109 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Targeting/GASXHitboxComponent.h"
+#include "Targeting/GASXHitboxSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/World.h"
+
+UGASXHitboxComponent::UGASXHitboxComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UGASXHitboxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RefreshCapsuleLayout();
+}
+
+void UGASXHitboxComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGASXHitboxSubsystem* HitboxSubsystem = UWorld::GetSubsystem<UGASXHitboxSubsystem>(GetWorld()))
+	{
+		HitboxSubsystem->UnregisterHitboxComponent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UGASXHitboxComponent::RefreshCapsuleLayout()
+{
+	MeshComponent = GetOwner() ? GetOwner()->FindComponentByClass<USkeletalMeshComponent>() : nullptr;
+
+	GeneratedCapsules.Reset();
+	if (Capsules.IsEmpty() && bBuildFromPhysicsAsset)
+	{
+		BuildCapsulesFromPhysicsAsset();
+	}
+
+	const TArray<FGASXHitboxCapsule>& CapsulesInUse = GetCapsules();
+	BoneIndices.Reset(CapsulesInUse.Num());
+	for (const FGASXHitboxCapsule& Capsule : CapsulesInUse)
+	{
+		BoneIndices.Add(MeshComponent.IsValid() && !Capsule.BoneName.IsNone() ? MeshComponent->GetBoneIndex(Capsule.BoneName) : INDEX_NONE);
+	}
+
+	// Registering again marks the layout dirty, so the subsystem picks up the new capsules.
+	if (UGASXHitboxSubsystem* HitboxSubsystem = UWorld::GetSubsystem<UGASXHitboxSubsystem>(GetWorld()))
+	{
+		HitboxSubsystem->RegisterHitboxComponent(this);
+	}
+}
+
+void UGASXHitboxComponent::BuildCapsulesFromPhysicsAsset()
+{
+	const UPhysicsAsset* PhysicsAsset = MeshComponent.IsValid() ? MeshComponent->GetPhysicsAsset() : nullptr;
+	if (!PhysicsAsset)
+	{
+		return;
+	}
+
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+	{
+		if (!BodySetup) continue;
+
+		for (const FKSphylElem& Sphyl : BodySetup->AggGeom.SphylElems)
+		{
+			FGASXHitboxCapsule& Capsule = GeneratedCapsules.AddDefaulted_GetRef();
+			Capsule.BoneName = BodySetup->BoneName;
+			Capsule.Center = Sphyl.Center;
+			Capsule.Rotation = Sphyl.Rotation;
+			Capsule.Radius = Sphyl.Radius;
+			Capsule.Length = Sphyl.Length;
+		}
+
+		for (const FKSphereElem& Sphere : BodySetup->AggGeom.SphereElems)
+		{
+			FGASXHitboxCapsule& Capsule = GeneratedCapsules.AddDefaulted_GetRef();
+			Capsule.BoneName = BodySetup->BoneName;
+			Capsule.Center = Sphere.Center;
+			Capsule.Radius = Sphere.Radius;
+		}
+	}
+}
+
+void UGASXHitboxComponent::GetWorldCapsule(int32 CapsuleIndex, FVector& OutA, FVector& OutB, float& OutRadius) const
+{
+	const FGASXHitboxCapsule& Capsule = GetCapsules()[CapsuleIndex];
+	const USkeletalMeshComponent* Mesh = MeshComponent.Get();
+
+	FTransform BoneTransform = FTransform::Identity;
+	if (Mesh)
+	{
+		const int32 BoneIndex = BoneIndices.IsValidIndex(CapsuleIndex) ? BoneIndices[CapsuleIndex] : INDEX_NONE;
+		BoneTransform = BoneIndex != INDEX_NONE ? Mesh->GetBoneTransform(BoneIndex) : Mesh->GetComponentTransform();
+	}
+	else if (const AActor* Owner = GetOwner())
+	{
+		BoneTransform = Owner->GetActorTransform();
+	}
+
+	const FVector HalfAxis = Capsule.Rotation.RotateVector(FVector(0.f, 0.f, Capsule.Length * 0.5f));
+	OutA = BoneTransform.TransformPosition(Capsule.Center + HalfAxis);
+	OutB = BoneTransform.TransformPosition(Capsule.Center - HalfAxis);
+	OutRadius = Capsule.Radius * BoneTransform.GetMaximumAxisScale();
+}
@@ -0,0 +1,132 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Targeting/GASXHitboxSubsystem.h"
+#include "Targeting/GASXHitboxComponent.h"
+#include "GASXMacroDefinitions.h"
+
+DECLARE_CYCLE_STAT(TEXT("Refresh Hitbox Capsules"), STAT_GASXRefreshHitboxCapsules, STATGROUP_GASXTargeting);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Query"), STAT_GASXHitboxQuery, STATGROUP_GASXTargeting);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hitbox Capsules"), STAT_GASXHitboxCapsules, STATGROUP_GASXTargeting);
+
+bool UGASXHitboxSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGASXHitboxSubsystem::RegisterHitboxComponent(UGASXHitboxComponent* Component)
+{
+	if (Component)
+	{
+		Components.AddUnique(Component);
+		bLayoutDirty = true;
+	}
+}
+
+void UGASXHitboxSubsystem::UnregisterHitboxComponent(UGASXHitboxComponent* Component)
+{
+	if (Components.Remove(Component) > 0)
+	{
+		bLayoutDirty = true;
+	}
+}
+
+void UGASXHitboxSubsystem::RebuildLayout()
+{
+	Components.RemoveAll([](const TWeakObjectPtr<UGASXHitboxComponent>& Component) { return !Component.IsValid(); });
+
+	CapsuleComponentIndices.Reset();
+	CapsuleLocalIndices.Reset();
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ++ComponentIndex)
+	{
+		const int32 NumCapsules = Components[ComponentIndex]->GetCapsules().Num();
+		for (int32 LocalIndex = 0; LocalIndex < NumCapsules; ++LocalIndex)
+		{
+			CapsuleComponentIndices.Add(ComponentIndex);
+			CapsuleLocalIndices.Add(LocalIndex);
+		}
+	}
+
+	const int32 NumPadded = Align(CapsuleComponentIndices.Num(), 4);
+	for (TArray<float>* Array : { &AX, &AY, &AZ, &BX, &BY, &BZ, &Radius })
+	{
+		Array->SetNumZeroed(NumPadded);
+	}
+
+	SET_DWORD_STAT(STAT_GASXHitboxCapsules, CapsuleComponentIndices.Num());
+	bLayoutDirty = false;
+}
+
+void UGASXHitboxSubsystem::RefreshCapsules()
+{
+	if (!bLayoutDirty && LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXRefreshHitboxCapsules);
+
+	// A component may have been destroyed without EndPlay, e.g. when its world is torn down.
+	if (!bLayoutDirty && Components.ContainsByPredicate([](const TWeakObjectPtr<UGASXHitboxComponent>& Component) { return !Component.IsValid(); }))
+	{
+		bLayoutDirty = true;
+	}
+	if (bLayoutDirty)
+	{
+		RebuildLayout();
+	}
+
+	for (int32 Index = 0; Index < CapsuleComponentIndices.Num(); ++Index)
+	{
+		FVector A, B;
+		float CapsuleRadius;
+		Components[CapsuleComponentIndices[Index]]->GetWorldCapsule(CapsuleLocalIndices[Index], A, B, CapsuleRadius);
+
+		AX[Index] = (float)A.X;
+		AY[Index] = (float)A.Y;
+		AZ[Index] = (float)A.Z;
+		BX[Index] = (float)B.X;
+		BY[Index] = (float)B.Y;
+		BZ[Index] = (float)B.Z;
+		Radius[Index] = CapsuleRadius;
+	}
+
+	LastRefreshFrame = GFrameCounter;
+}
+
+void UGASXHitboxSubsystem::SweepSphere(const FVector& Start, const FVector& End, float QueryRadius, TArray<FGASXHitboxHit>& OutHits)
+{
+	RefreshCapsules();
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXHitboxQuery);
+
+	const GASXAnalyticGeometry::FCapsuleArrays Capsules{ AX.GetData(), AY.GetData(), AZ.GetData(), BX.GetData(), BY.GetData(), BZ.GetData(), Radius.GetData(), CapsuleComponentIndices.Num() };
+	TArray<GASXAnalyticGeometry::FCapsuleHit, TInlineAllocator<32>> CapsuleHits;
+	GASXAnalyticGeometry::SweepSphereAgainstCapsules(FVector3f(Start), FVector3f(End), QueryRadius, Capsules, CapsuleHits);
+
+	AppendHits(CapsuleHits, OutHits);
+}
+
+void UGASXHitboxSubsystem::OverlapCone(const FVector& Apex, const FVector& Direction, float Range, float HalfAngleDegrees, TArray<FGASXHitboxHit>& OutHits)
+{
+	RefreshCapsules();
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXHitboxQuery);
+
+	const GASXAnalyticGeometry::FCapsuleArrays Capsules{ AX.GetData(), AY.GetData(), AZ.GetData(), BX.GetData(), BY.GetData(), BZ.GetData(), Radius.GetData(), CapsuleComponentIndices.Num() };
+	TArray<GASXAnalyticGeometry::FCapsuleHit, TInlineAllocator<32>> CapsuleHits;
+	GASXAnalyticGeometry::ConeAgainstCapsules(FVector3f(Apex), FVector3f(Direction.GetSafeNormal()), Range, FMath::DegreesToRadians(HalfAngleDegrees), Capsules, CapsuleHits);
+
+	AppendHits(CapsuleHits, OutHits);
+}
+
+void UGASXHitboxSubsystem::AppendHits(TConstArrayView<GASXAnalyticGeometry::FCapsuleHit> CapsuleHits, TArray<FGASXHitboxHit>& OutHits) const
+{
+	OutHits.Reserve(OutHits.Num() + CapsuleHits.Num());
+	for (const GASXAnalyticGeometry::FCapsuleHit& CapsuleHit : CapsuleHits)
+	{
+		FGASXHitboxHit& Hit = OutHits.AddDefaulted_GetRef();
+		Hit.Component = Components[CapsuleComponentIndices[CapsuleHit.Index]].Get();
+		Hit.CapsuleIndex = CapsuleLocalIndices[CapsuleHit.Index];
+		Hit.Time = CapsuleHit.Time;
+	}
+}
@@ -0,0 +1,318 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "Targeting/GASXLagCompensationSubsystem.h"
+#include "Targeting/GASXAnalyticGeometry.h"
+#include "GASXMacroDefinitions.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_CYCLE_STAT(TEXT("Record Lag Compensation Frame"), STAT_GASXRecordLagCompensationFrame, STATGROUP_GASXTargeting);
+DECLARE_CYCLE_STAT(TEXT("Lag Compensated Query"), STAT_GASXLagCompensatedQuery, STATGROUP_GASXTargeting);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensation Candidates"), STAT_GASXLagCompensationCandidates, STATGROUP_GASXTargeting);
+
+namespace GASXConsoleVariables
+{
+	static int32 LagCompensationHistoryFrames = 64;
+	static FAutoConsoleVariableRef CVarLagCompensationHistoryFrames(
+		TEXT("gasx.targeting.LagCompensation.HistoryFrames"),
+		LagCompensationHistoryFrames,
+		TEXT("Number of frames recorded for lag compensated targeting. Changing this clears the history."),
+		ECVF_Default);
+}
+
+bool UGASXLagCompensationSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Only servers rewind
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->GetNetMode() != NM_Client;
+}
+
+bool UGASXLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGASXLagCompensationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (TActorIterator<APawn> It(&InWorld); It; ++It)
+	{
+		RegisterActor(*It);
+	}
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UGASXLagCompensationSubsystem::OnActorSpawned));
+}
+
+void UGASXLagCompensationSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UGASXLagCompensationSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->IsA<APawn>())
+	{
+		RegisterActor(Actor);
+	}
+}
+
+TStatId UGASXLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGASXLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UGASXLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RecordFrame();
+}
+
+void UGASXLagCompensationSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!Actor || SlotByActor.Contains(Actor))
+	{
+		return;
+	}
+
+	if (FreeSlots.IsEmpty())
+	{
+		const int32 OldCapacity = SlotCapacity;
+		Reallocate(FMath::Max(HistoryLength, 1), Align(FMath::Max(16, SlotCapacity * 2), 4));
+		SlotActors.SetNum(SlotCapacity);
+		SlotKeys.SetNum(SlotCapacity);
+		for (int32 Slot = SlotCapacity - 1; Slot >= OldCapacity; --Slot)
+		{
+			FreeSlots.Add(Slot);
+		}
+	}
+
+	const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+	SlotActors[Slot] = Actor;
+	SlotKeys[Slot] = Actor;
+	SlotByActor.Add(Actor, Slot);
+}
+
+void UGASXLagCompensationSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Slot = INDEX_NONE;
+	if (SlotByActor.RemoveAndCopyValue(Actor, Slot))
+	{
+		FreeSlot(Slot);
+	}
+}
+
+void UGASXLagCompensationSubsystem::FreeSlot(int32 Slot)
+{
+	SlotActors[Slot].Reset();
+	SlotKeys[Slot] = TObjectKey<AActor>();
+	FreeSlots.Add(Slot);
+
+	// The history of this slot must not be mistaken for the next actor using it.
+	for (int32 Frame = 0; Frame < HistoryLength; ++Frame)
+	{
+		Radius[Frame * SlotCapacity + Slot] = -1.f;
+	}
+}
+
+void UGASXLagCompensationSubsystem::Reallocate(int32 NewHistoryLength, int32 NewSlotCapacity)
+{
+	const bool bKeepHistory = NewHistoryLength == HistoryLength;
+	const int32 NewSize = NewHistoryLength * NewSlotCapacity;
+
+	TArray<float>* Arrays[] = { &AX, &AY, &AZ, &BX, &BY, &BZ, &Radius };
+	for (TArray<float>* Array : Arrays)
+	{
+		TArray<float> NewArray;
+		NewArray.Init(Array == &Radius ? -1.f : 0.f, NewSize);
+
+		// Copy each frame block into the new layout
+		if (bKeepHistory)
+		{
+			for (int32 Frame = 0; Frame < HistoryLength; ++Frame)
+			{
+				FMemory::Memcpy(NewArray.GetData() + Frame * NewSlotCapacity, Array->GetData() + Frame * SlotCapacity, SlotCapacity * sizeof(float));
+			}
+		}
+		*Array = MoveTemp(NewArray);
+	}
+
+	if (!bKeepHistory)
+	{
+		FrameTimes.SetNumZeroed(NewHistoryLength);
+		NewestFrame = INDEX_NONE;
+		NumRecordedFrames = 0;
+	}
+
+	HistoryLength = NewHistoryLength;
+	SlotCapacity = NewSlotCapacity;
+}
+
+void UGASXLagCompensationSubsystem::RecordFrame()
+{
+	if (SlotByActor.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXRecordLagCompensationFrame);
+
+	const int32 DesiredHistoryLength = FMath::Max(GASXConsoleVariables::LagCompensationHistoryFrames, 2);
+	if (DesiredHistoryLength != HistoryLength)
+	{
+		Reallocate(DesiredHistoryLength, SlotCapacity);
+	}
+
+	NewestFrame = (NewestFrame + 1) % HistoryLength;
+	NumRecordedFrames = FMath::Min(NumRecordedFrames + 1, HistoryLength);
+	FrameTimes[NewestFrame] = GetWorld()->GetTimeSeconds();
+
+	const int32 Base = NewestFrame * SlotCapacity;
+	for (int32 Slot = 0; Slot < SlotCapacity; ++Slot)
+	{
+		const int32 Index = Base + Slot;
+		const AActor* Actor = SlotActors[Slot].Get();
+		if (!Actor)
+		{
+			if (!SlotActors[Slot].IsExplicitlyNull())
+			{
+				// Destroyed without being unregistered
+				SlotByActor.Remove(SlotKeys[Slot]);
+				FreeSlot(Slot);
+			}
+			Radius[Index] = -1.f;
+			continue;
+		}
+
+		// Upright capsule from the simple collision cylinder, which is the capsule for characters.
+		float CylinderRadius, CylinderHalfHeight;
+		Actor->GetSimpleCollisionCylinder(CylinderRadius, CylinderHalfHeight);
+		const FVector Center = Actor->GetActorLocation();
+		const float HalfSegment = FMath::Max(CylinderHalfHeight - CylinderRadius, 0.f);
+
+		AX[Index] = (float)Center.X;
+		AY[Index] = (float)Center.Y;
+		AZ[Index] = (float)(Center.Z + HalfSegment);
+		BX[Index] = (float)Center.X;
+		BY[Index] = (float)Center.Y;
+		BZ[Index] = (float)(Center.Z - HalfSegment);
+		Radius[Index] = CylinderRadius;
+	}
+}
+
+bool UGASXLagCompensationSubsystem::GetHistoryTimeRange(double& OutOldest, double& OutNewest) const
+{
+	if (NumRecordedFrames == 0)
+	{
+		return false;
+	}
+
+	const int32 OldestFrame = (NewestFrame - NumRecordedFrames + 1 + HistoryLength) % HistoryLength;
+	OutOldest = FrameTimes[OldestFrame];
+	OutNewest = FrameTimes[NewestFrame];
+	return true;
+}
+
+void UGASXLagCompensationSubsystem::SweepSphereAtTime(double Timestamp, const FVector& Start, const FVector& End, float QueryRadius, TArray<FGASXRewoundHit>& OutHits) const
+{
+	if (NumRecordedFrames == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GASXLagCompensatedQuery);
+
+	// Find the recorded frames around Timestamp, walking back from the newest one.
+	int32 NewerFrame = NewestFrame;
+	int32 OlderFrame = NewestFrame;
+	for (int32 Step = 1; Step < NumRecordedFrames && FrameTimes[OlderFrame] > Timestamp; ++Step)
+	{
+		NewerFrame = OlderFrame;
+		OlderFrame = (OlderFrame - 1 + HistoryLength) % HistoryLength;
+	}
+
+	const double OlderTime = FrameTimes[OlderFrame];
+	const double NewerTime = FrameTimes[NewerFrame];
+	const float Alpha = NewerTime > OlderTime ? (float)FMath::Clamp((Timestamp - OlderTime) / (NewerTime - OlderTime), 0.0, 1.0) : 1.f;
+
+	// Swept bounds of the query. Candidates outside of them are never tested.
+	const FBox3f QueryBounds = FBox3f(FVector3f(Start.ComponentMin(End)), FVector3f(Start.ComponentMax(End))).ExpandBy(QueryRadius);
+
+	TArray<float, TInlineAllocator<64>> CandidateAX, CandidateAY, CandidateAZ, CandidateBX, CandidateBY, CandidateBZ, CandidateRadius;
+	TArray<int32, TInlineAllocator<64>> CandidateSlots;
+
+	const int32 OlderBase = OlderFrame * SlotCapacity;
+	const int32 NewerBase = NewerFrame * SlotCapacity;
+	for (int32 Slot = 0; Slot < SlotCapacity; ++Slot)
+	{
+		const int32 Older = OlderBase + Slot;
+		const int32 Newer = NewerBase + Slot;
+		if (Radius[Newer] < 0.f)
+		{
+			continue;
+		}
+
+		// If the actor wasn't tracked yet in the older frame, use the newer one as is.
+		const float SlotAlpha = Radius[Older] < 0.f ? 1.f : Alpha;
+		const FVector3f A(FMath::Lerp(AX[Older], AX[Newer], SlotAlpha), FMath::Lerp(AY[Older], AY[Newer], SlotAlpha), FMath::Lerp(AZ[Older], AZ[Newer], SlotAlpha));
+		const FVector3f B(FMath::Lerp(BX[Older], BX[Newer], SlotAlpha), FMath::Lerp(BY[Older], BY[Newer], SlotAlpha), FMath::Lerp(BZ[Older], BZ[Newer], SlotAlpha));
+		const float CapsuleRadius = Radius[Newer];
+
+		const FBox3f CapsuleBounds = FBox3f(A.ComponentMin(B), A.ComponentMax(B)).ExpandBy(CapsuleRadius);
+		if (!CapsuleBounds.Intersect(QueryBounds))
+		{
+			continue;
+		}
+
+		CandidateAX.Add(A.X);
+		CandidateAY.Add(A.Y);
+		CandidateAZ.Add(A.Z);
+		CandidateBX.Add(B.X);
+		CandidateBY.Add(B.Y);
+		CandidateBZ.Add(B.Z);
+		CandidateRadius.Add(CapsuleRadius);
+		CandidateSlots.Add(Slot);
+	}
+
+	const int32 NumCandidates = CandidateSlots.Num();
+	INC_DWORD_STAT_BY(STAT_GASXLagCompensationCandidates, NumCandidates);
+	if (NumCandidates == 0)
+	{
+		return;
+	}
+
+	// Pad for the vector loop
+	const int32 NumPadded = Align(NumCandidates, 4);
+	for (auto* Array : { &CandidateAX, &CandidateAY, &CandidateAZ, &CandidateBX, &CandidateBY, &CandidateBZ, &CandidateRadius })
+	{
+		Array->SetNumZeroed(NumPadded);
+	}
+
+	const GASXAnalyticGeometry::FCapsuleArrays Capsules{ CandidateAX.GetData(), CandidateAY.GetData(), CandidateAZ.GetData(), CandidateBX.GetData(), CandidateBY.GetData(), CandidateBZ.GetData(), CandidateRadius.GetData(), NumCandidates };
+	TArray<GASXAnalyticGeometry::FCapsuleHit, TInlineAllocator<16>> CapsuleHits;
+	GASXAnalyticGeometry::SweepSphereAgainstCapsules(FVector3f(Start), FVector3f(End), QueryRadius, Capsules, CapsuleHits);
+
+	for (const GASXAnalyticGeometry::FCapsuleHit& CapsuleHit : CapsuleHits)
+	{
+		AActor* Actor = SlotActors[CandidateSlots[CapsuleHit.Index]].Get();
+		if (!Actor) continue;
+
+		FGASXRewoundHit& Hit = OutHits.AddDefaulted_GetRef();
+		Hit.Actor = Actor;
+		Hit.Time = CapsuleHit.Time;
+		Hit.CapsuleA = FVector(CandidateAX[CapsuleHit.Index], CandidateAY[CapsuleHit.Index], CandidateAZ[CapsuleHit.Index]);
+		Hit.CapsuleB = FVector(CandidateBX[CapsuleHit.Index], CandidateBY[CapsuleHit.Index], CandidateBZ[CapsuleHit.Index]);
+		Hit.CapsuleRadius = CandidateRadius[CapsuleHit.Index];
+	}
+}
@@ -0,0 +1,483 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "GASXTargetType.h"
+#include "Targeting/GASXHitboxComponent.h"
+#include "GASXMacroDefinitions.h"
+#include "Abilities/GameplayAbilityTypes.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+#include "TimerManager.h"
+#include "UObject/StrongObjectPtr.h"
+
+/**
+ * Benchmark of target types against grids of collision actors.
+ *
+ * Usage: gasx.targeting.Benchmark [GridSizes=10,100,1000,5000] [Iterations=100] [Quit]
+ * Headless: UnrealEditor-Cmd <Project> <Map> -game -nullrhi -ExecCmds="gasx.targeting.Benchmark Quit"
+ *
+ * Every combination of trace shape, hit type and target type is timed with and without Filter, as well as the overlap target types.
+ * Multi traces are also timed with MaxTargets and each TargetPriority, and the hitbox target type against a capsule on every grid actor.
+ * Results are written as CSV and JSON to Saved/Profiling/GASXTargeting.
+ */
+namespace GASXTargetingBenchmark
+{
+	constexpr float GridSpacing = 200.f;
+	constexpr int32 SelectionMaxTargets = 5;
+
+	/** Forwards to the real allocator and counts allocations made on the game thread. Only installed while the benchmark measures. */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		FMalloc* Inner = nullptr;
+		uint64 NumAllocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		FORCEINLINE void Count1()
+		{
+			if (IsInGameThread())
+			{
+				++NumAllocations;
+			}
+		}
+	};
+
+	// Never destroyed, as other threads may still be calling into it after it is uninstalled.
+	static FCountingMalloc CountingMalloc;
+
+	struct FScopedAllocationCounter
+	{
+		FScopedAllocationCounter()
+		{
+			CountingMalloc.Inner = GMalloc;
+			CountingMalloc.NumAllocations = 0;
+			GMalloc = &CountingMalloc;
+		}
+		~FScopedAllocationCounter()
+		{
+			GMalloc = CountingMalloc.Inner;
+		}
+	};
+
+	struct FCase
+	{
+		FString Name;
+		FString Shape;
+		FString HitType;
+		FString TargetType;
+		FString Selection = TEXT("All");
+		bool bFiltered = false;
+		TStrongObjectPtr<UGASXTargetType> TargetTypeObject;
+	};
+
+	struct FResult
+	{
+		int32 GridSize = 0;
+		const FCase* Case = nullptr;
+		double P50Microseconds = 0.0;
+		double P99Microseconds = 0.0;
+		double MeanAllocations = 0.0;
+		double MeanTargets = 0.0;
+	};
+
+	class FRunner : public TSharedFromThis<FRunner>
+	{
+	public:
+		TWeakObjectPtr<UWorld> World;
+		TArray<int32> GridSizes;
+		int32 Iterations = 100;
+		bool bQuitWhenDone = false;
+
+		void Start()
+		{
+			BuildCases();
+			SpawnSource();
+			SpawnNextGrid();
+		}
+
+	private:
+		TArray<FCase> Cases;
+		TArray<FResult> Results;
+		TArray<TWeakObjectPtr<AActor>> GridActors;
+		TWeakObjectPtr<AActor> SourceActor;
+		int32 GridIndex = 0;
+
+		static FString ShapeName(EGASXTraceShapeType Shape)
+		{
+			return StaticEnum<EGASXTraceShapeType>()->GetNameStringByValue((int64)Shape);
+		}
+
+		static FString TargetTypeName(EGASXTraceTargetType TargetType)
+		{
+			return StaticEnum<EGASXTraceTargetType>()->GetNameStringByValue((int64)TargetType);
+		}
+
+		static void SetupFilter(UGASXTargetType* TargetType, bool bFiltered)
+		{
+			if (bFiltered)
+			{
+				TargetType->Filter.SelfFilter = ETargetDataFilterSelf::TDFS_NoSelf;
+				TargetType->Filter.RequiredActorClass = AActor::StaticClass();
+				TargetType->bFilterHitResults = true;
+			}
+			TargetType->bAllowFrameCache = false;
+			TargetType->CompileFilter();
+		}
+
+		void AddTraceCase(EGASXTraceShapeType Shape, EGASXTraceHitType HitType, EGASXTraceTargetType TargetType, bool bFiltered)
+		{
+			UGASXTargetType_TraceFromAvatarActor* Trace = NewObject<UGASXTargetType_TraceFromAvatarActor>(GetTransientPackage());
+			Trace->TraceShapeType = Shape;
+			Trace->TraceHitType = HitType;
+			Trace->TraceTargetType = TargetType;
+			Trace->ProfileName.Name = UCollisionProfile::BlockAllDynamic_ProfileName;
+			Trace->ObjectTypes = { UEngineTypes::ConvertToObjectType(ECC_WorldDynamic) };
+			Trace->TraceRadius = 30.f;
+			Trace->CapsuleTraceHalfHeight = 60.f;
+			Trace->BoxTraceHalfSize = FVector(30.f);
+			Trace->TraceLength = 100000.f;
+			Trace->BuildCollisionQuery();
+			SetupFilter(Trace, bFiltered);
+
+			FCase& Case = Cases.AddDefaulted_GetRef();
+			Case.Shape = ShapeName(Shape);
+			Case.HitType = StaticEnum<EGASXTraceHitType>()->GetNameStringByValue((int64)HitType);
+			Case.TargetType = TargetTypeName(TargetType);
+			Case.bFiltered = bFiltered;
+			Case.Name = FString::Printf(TEXT("Trace_%s_%s_%s%s"), *Case.Shape, *Case.HitType, *Case.TargetType, bFiltered ? TEXT("_Filtered") : TEXT(""));
+			Case.TargetTypeObject.Reset(Trace);
+		}
+
+		void AddSelectionCase(EGASXTargetPriority Priority, bool bFiltered)
+		{
+			// Object type queries never block, so multi traces return every actor along the way to rank.
+			AddTraceCase(EGASXTraceShapeType::TST_SphereTrace, EGASXTraceHitType::THT_MultiTrace, EGASXTraceTargetType::TTT_ByObjectTypes, bFiltered);
+			FCase& Case = Cases.Last();
+			UGASXTargetType_TraceBase* Trace = CastChecked<UGASXTargetType_TraceBase>(Case.TargetTypeObject.Get());
+			Trace->MaxTargets = SelectionMaxTargets;
+			Trace->TargetPriority = Priority;
+
+			Case.Selection = FString::Printf(TEXT("Max%d_%s"), SelectionMaxTargets, *StaticEnum<EGASXTargetPriority>()->GetNameStringByValue((int64)Priority));
+			Case.Name += TEXT("_") + Case.Selection;
+		}
+
+		void AddHitboxCase(EGASXHitboxQueryShape QueryShape, bool bFiltered)
+		{
+			UGASXTargetType_Hitbox* Hitbox = NewObject<UGASXTargetType_Hitbox>(GetTransientPackage());
+			Hitbox->QueryShape = QueryShape;
+			Hitbox->Range = QueryShape == EGASXHitboxQueryShape::HQS_Cone ? 1000.f : 100000.f;
+			Hitbox->Radius = 30.f;
+			SetupFilter(Hitbox, bFiltered);
+
+			FCase& Case = Cases.AddDefaulted_GetRef();
+			Case.Shape = StaticEnum<EGASXHitboxQueryShape>()->GetNameStringByValue((int64)QueryShape);
+			Case.HitType = TEXT("Hitbox");
+			Case.TargetType = TEXT("Hitbox");
+			Case.bFiltered = bFiltered;
+			Case.Name = FString::Printf(TEXT("Hitbox_%s%s"), *Case.Shape, bFiltered ? TEXT("_Filtered") : TEXT(""));
+			Case.TargetTypeObject.Reset(Hitbox);
+		}
+
+		void AddOverlapCase(TSubclassOf<UGASXTargetType_OverlapBase> Class, EGASXTraceTargetType TargetType, bool bFiltered)
+		{
+			UGASXTargetType_OverlapBase* Overlap = NewObject<UGASXTargetType_OverlapBase>(GetTransientPackage(), Class);
+			Overlap->OverlapTargetType = TargetType;
+			Overlap->ProfileName.Name = UCollisionProfile::BlockAllDynamic_ProfileName;
+			Overlap->ObjectTypes = { UEngineTypes::ConvertToObjectType(ECC_WorldDynamic) };
+			if (UGASXTargetType_OverlapSphere* Sphere = Cast<UGASXTargetType_OverlapSphere>(Overlap))
+			{
+				Sphere->Radius = 1000.f;
+			}
+			else if (UGASXTargetType_OverlapBox* Box = Cast<UGASXTargetType_OverlapBox>(Overlap))
+			{
+				Box->BoxHalfExtent = FVector(1000.f, 500.f, 200.f);
+			}
+			else if (UGASXTargetType_Cone* Cone = Cast<UGASXTargetType_Cone>(Overlap))
+			{
+				Cone->Range = 1000.f;
+			}
+			Overlap->BuildOverlapQuery();
+			SetupFilter(Overlap, bFiltered);
+
+			FCase& Case = Cases.AddDefaulted_GetRef();
+			Case.Shape = Class->GetName();
+			Case.HitType = TEXT("Overlap");
+			Case.TargetType = TargetTypeName(TargetType);
+			Case.bFiltered = bFiltered;
+			Case.Name = FString::Printf(TEXT("%s_%s%s"), *Case.Shape, *Case.TargetType, bFiltered ? TEXT("_Filtered") : TEXT(""));
+			Case.TargetTypeObject.Reset(Overlap);
+		}
+
+		void BuildCases()
+		{
+			const EGASXTraceShapeType Shapes[] = { EGASXTraceShapeType::TST_LineTrace, EGASXTraceShapeType::TST_SphereTrace, EGASXTraceShapeType::TST_CapsuleTrace, EGASXTraceShapeType::TST_BoxTrace };
+			const EGASXTraceHitType HitTypes[] = { EGASXTraceHitType::THT_SingleTrace, EGASXTraceHitType::THT_MultiTrace };
+			const EGASXTraceTargetType TargetTypes[] = { EGASXTraceTargetType::TTT_ByChannel, EGASXTraceTargetType::TTT_ByProfile, EGASXTraceTargetType::TTT_ByObjectTypes };
+			const TSubclassOf<UGASXTargetType_OverlapBase> OverlapClasses[] = { UGASXTargetType_OverlapSphere::StaticClass(), UGASXTargetType_OverlapBox::StaticClass(), UGASXTargetType_Cone::StaticClass() };
+			const EGASXTargetPriority Priorities[] = { EGASXTargetPriority::TP_None, EGASXTargetPriority::TP_Distance, EGASXTargetPriority::TP_AngleToForward };
+			const EGASXHitboxQueryShape HitboxShapes[] = { EGASXHitboxQueryShape::HQS_Ray, EGASXHitboxQueryShape::HQS_Sphere, EGASXHitboxQueryShape::HQS_Cone };
+
+			for (const bool bFiltered : { false, true })
+			{
+				for (const EGASXTraceTargetType TargetType : TargetTypes)
+				{
+					for (const EGASXTraceShapeType Shape : Shapes)
+					{
+						for (const EGASXTraceHitType HitType : HitTypes)
+						{
+							AddTraceCase(Shape, HitType, TargetType, bFiltered);
+						}
+					}
+					for (const TSubclassOf<UGASXTargetType_OverlapBase>& Class : OverlapClasses)
+					{
+						AddOverlapCase(Class, TargetType, bFiltered);
+					}
+				}
+				for (const EGASXTargetPriority Priority : Priorities)
+				{
+					AddSelectionCase(Priority, bFiltered);
+				}
+				for (const EGASXHitboxQueryShape QueryShape : HitboxShapes)
+				{
+					AddHitboxCase(QueryShape, bFiltered);
+				}
+			}
+		}
+
+		void SpawnSource()
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.ObjectFlags |= RF_Transient;
+			SourceActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(FVector(0.f, 0.f, 50.f)), SpawnParams);
+			USceneComponent* Root = NewObject<USceneComponent>(SourceActor.Get(), TEXT("Root"));
+			SourceActor->SetRootComponent(Root);
+			Root->RegisterComponent();
+			Root->SetWorldLocation(FVector(0.f, 0.f, 50.f));
+		}
+
+		void SpawnNextGrid()
+		{
+			UWorld* StrongWorld = World.Get();
+			if (!StrongWorld || !GridSizes.IsValidIndex(GridIndex))
+			{
+				Finish();
+				return;
+			}
+
+			// Square grid in front of the source, centered on its forward axis
+			const int32 NumActors = GridSizes[GridIndex];
+			const int32 Side = FMath::CeilToInt(FMath::Sqrt((float)NumActors));
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.ObjectFlags |= RF_Transient;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			GridActors.Reserve(NumActors);
+			for (int32 Index = 0; Index < NumActors; ++Index)
+			{
+				const FVector Location(GridSpacing * (1 + Index / Side), GridSpacing * (Index % Side - Side / 2), 50.f);
+				AActor* Actor = StrongWorld->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location), SpawnParams);
+				UBoxComponent* Box = NewObject<UBoxComponent>(Actor, TEXT("Box"));
+				Box->SetBoxExtent(FVector(40.f));
+				Box->SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+				Actor->SetRootComponent(Box);
+				Box->RegisterComponent();
+				Box->SetWorldLocation(Location);
+
+				// Without a skeletal mesh, the capsule follows the actor.
+				UGASXHitboxComponent* Hitbox = NewObject<UGASXHitboxComponent>(Actor, TEXT("Hitbox"));
+				Hitbox->bBuildFromPhysicsAsset = false;
+				FGASXHitboxCapsule& Capsule = Hitbox->Capsules.AddDefaulted_GetRef();
+				Capsule.Radius = 30.f;
+				Capsule.Length = 40.f;
+				Hitbox->RegisterComponent();
+
+				GridActors.Add(Actor);
+			}
+
+			// Let the physics scene pick up the new bodies before measuring.
+			StrongWorld->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateLambda([Runner = AsShared()]() { Runner->MeasureGrid(); }));
+		}
+
+		void MeasureGrid()
+		{
+			const int32 GridSize = GridSizes[GridIndex];
+
+			FGameplayAbilityActorInfo ActorInfo;
+			ActorInfo.OwnerActor = SourceActor;
+			ActorInfo.AvatarActor = SourceActor;
+			const FGameplayEventData EventData;
+
+			TArray<double> Samples;
+			Samples.SetNumUninitialized(Iterations);
+			for (const FCase& Case : Cases)
+			{
+				const UGASXTargetType* TargetType = Case.TargetTypeObject.Get();
+				uint64 TotalAllocations = 0;
+				int64 TotalTargets = 0;
+
+				// Warm up
+				for (int32 Iteration = 0; Iteration < 5; ++Iteration)
+				{
+					TArray<FHitResult> HitResults;
+					TArray<AActor*> Actors;
+					TargetType->DispatchGetTargets(ActorInfo, EventData, HitResults, Actors);
+				}
+
+				for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+				{
+					uint64 StartCycles, EndCycles, NumAllocations;
+					int32 NumTargets;
+					{
+						FScopedAllocationCounter AllocationCounter;
+						StartCycles = FPlatformTime::Cycles64();
+						{
+							TArray<FHitResult> HitResults;
+							TArray<AActor*> Actors;
+							TargetType->DispatchGetTargets(ActorInfo, EventData, HitResults, Actors);
+							NumTargets = HitResults.Num() + Actors.Num();
+						}
+						EndCycles = FPlatformTime::Cycles64();
+						NumAllocations = CountingMalloc.NumAllocations;
+					}
+					Samples[Iteration] = FPlatformTime::ToMilliseconds64(EndCycles - StartCycles) * 1000.0;
+					TotalAllocations += NumAllocations;
+					TotalTargets += NumTargets;
+				}
+
+				Samples.Sort();
+				FResult& Result = Results.AddDefaulted_GetRef();
+				Result.GridSize = GridSize;
+				Result.Case = &Case;
+				Result.P50Microseconds = Samples[Iterations / 2];
+				Result.P99Microseconds = Samples[FMath::Min(FMath::CeilToInt(Iterations * 0.99) - 1, Iterations - 1)];
+				Result.MeanAllocations = (double)TotalAllocations / Iterations;
+				Result.MeanTargets = (double)TotalTargets / Iterations;
+			}
+
+			UE_LOG(LogGASX, Display, TEXT("GASX targeting benchmark: measured %d cases against %d actors."), Cases.Num(), GridSize);
+
+			for (const TWeakObjectPtr<AActor>& Actor : GridActors)
+			{
+				if (Actor.IsValid())
+				{
+					Actor->Destroy();
+				}
+			}
+			GridActors.Reset();
+
+			++GridIndex;
+			SpawnNextGrid();
+		}
+
+		void Finish()
+		{
+			if (SourceActor.IsValid())
+			{
+				SourceActor->Destroy();
+			}
+
+			const FString Directory = FPaths::ProfilingDir() / TEXT("GASXTargeting");
+			const FString BaseName = Directory / FString::Printf(TEXT("TargetingBenchmark-%s"), *FDateTime::Now().ToString());
+
+			FString Csv = TEXT("GridSize,Case,Shape,HitType,TargetType,Selection,Filtered,P50us,P99us,Allocations,Targets\n");
+			FString Json;
+			TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&Json);
+			JsonWriter->WriteObjectStart();
+			JsonWriter->WriteValue(TEXT("Iterations"), Iterations);
+			JsonWriter->WriteArrayStart(TEXT("Results"));
+			for (const FResult& Result : Results)
+			{
+				Csv += FString::Printf(TEXT("%d,%s,%s,%s,%s,%s,%d,%.3f,%.3f,%.2f,%.2f\n"), Result.GridSize, *Result.Case->Name, *Result.Case->Shape, *Result.Case->HitType, *Result.Case->TargetType, *Result.Case->Selection,
+					Result.Case->bFiltered ? 1 : 0, Result.P50Microseconds, Result.P99Microseconds, Result.MeanAllocations, Result.MeanTargets);
+
+				JsonWriter->WriteObjectStart();
+				JsonWriter->WriteValue(TEXT("GridSize"), Result.GridSize);
+				JsonWriter->WriteValue(TEXT("Case"), Result.Case->Name);
+				JsonWriter->WriteValue(TEXT("Shape"), Result.Case->Shape);
+				JsonWriter->WriteValue(TEXT("HitType"), Result.Case->HitType);
+				JsonWriter->WriteValue(TEXT("TargetType"), Result.Case->TargetType);
+				JsonWriter->WriteValue(TEXT("Selection"), Result.Case->Selection);
+				JsonWriter->WriteValue(TEXT("Filtered"), Result.Case->bFiltered);
+				JsonWriter->WriteValue(TEXT("P50us"), Result.P50Microseconds);
+				JsonWriter->WriteValue(TEXT("P99us"), Result.P99Microseconds);
+				JsonWriter->WriteValue(TEXT("Allocations"), Result.MeanAllocations);
+				JsonWriter->WriteValue(TEXT("Targets"), Result.MeanTargets);
+				JsonWriter->WriteObjectEnd();
+			}
+			JsonWriter->WriteArrayEnd();
+			JsonWriter->WriteObjectEnd();
+			JsonWriter->Close();
+
+			FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv")));
+			FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json")));
+			UE_LOG(LogGASX, Display, TEXT("GASX targeting benchmark: wrote %d results to %s.csv/.json"), Results.Num(), *BaseName);
+
+			if (bQuitWhenDone)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+	};
+
+	static void RunBenchmark(const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			UE_LOG(LogGASX, Warning, TEXT("gasx.targeting.Benchmark needs a game world."));
+			return;
+		}
+
+		TSharedRef<FRunner> Runner = MakeShared<FRunner>();
+		Runner->World = World;
+
+		const FString CommandLine = FString::Join(Args, TEXT(" "));
+		FString GridSizes = TEXT("10,100,1000,5000");
+		FParse::Value(*CommandLine, TEXT("GridSizes="), GridSizes);
+		FParse::Value(*CommandLine, TEXT("Iterations="), Runner->Iterations);
+		Runner->Iterations = FMath::Max(Runner->Iterations, 1);
+		Runner->bQuitWhenDone = Args.Contains(TEXT("Quit"));
+
+		TArray<FString> GridSizeStrings;
+		GridSizes.ParseIntoArray(GridSizeStrings, TEXT(","));
+		for (const FString& GridSize : GridSizeStrings)
+		{
+			Runner->GridSizes.Add(FMath::Clamp(FCString::Atoi(*GridSize), 1, 5000));
+		}
+
+		// The runner keeps itself alive through the timer delegates until it is done.
+		Runner->Start();
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdTargetingBenchmark(
+		TEXT("gasx.targeting.Benchmark"),
+		TEXT("Times GASX target types against grids of collision actors and writes CSV and JSON to Saved/Profiling/GASXTargeting. Args: [GridSizes=10,100,1000,5000] [Iterations=100] [Quit]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(RunBenchmark));
+}
+
+#endif // !UE_BUILD_SHIPPING
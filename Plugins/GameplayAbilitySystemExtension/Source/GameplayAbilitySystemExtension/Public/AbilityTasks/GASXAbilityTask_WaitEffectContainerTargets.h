@@ -0,0 +1,44 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/Tasks/AbilityTask.h"
+#include "Abilities/GameplayAbilityTypes.h"
+#include "GASXDataTypes.h"
+#include "GASXAbilityTask_WaitEffectContainerTargets.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWaitEffectContainerTargetsDelegate, const FGASXGameplayEffectContainerSpec&, ContainerSpec);
+
+/**
+ * Makes a gameplay effect container spec whose targets are resolved with UGASXTargetType::GetTargetsAsync().
+ * Trace target types run async scene queries, so OnTargetsReady is broadcast next frame at the earliest.
+ * The owning ability must be a UGASXGameplayAbility.
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXAbilityTask_WaitEffectContainerTargets : public UAbilityTask
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FWaitEffectContainerTargetsDelegate OnTargetsReady;
+
+	virtual FString GetDebugString() const override;
+
+	/** Make a gameplay effect container spec from the passed in container and wait until its targets are ready. */
+	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", AutoCreateRefTerm = "EventData", BlueprintInternalUseOnly = "TRUE"))
+	static UGASXAbilityTask_WaitEffectContainerTargets* WaitEffectContainerTargets(UGameplayAbility* OwningAbility, const FGASXGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
+
+	virtual void Activate() override;
+
+protected:
+	FGASXGameplayEffectContainer Container;
+	FGameplayEventData EventData;
+	int32 OverrideGameplayLevel;
+
+	// The spec being built. Targets are added when they are ready.
+	FGASXGameplayEffectContainerSpec ContainerSpec;
+
+	void HandleTargetsReady(const TArray<FHitResult>& HitResults, const TArray<AActor*>& Actors);
+};
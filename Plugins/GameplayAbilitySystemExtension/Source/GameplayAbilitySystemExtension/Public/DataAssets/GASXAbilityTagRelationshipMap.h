@@ -4,6 +4,7 @@
 
 #include "Engine/DataAsset.h"
 #include "GameplayTagContainer.h"
+#include "Containers/Map.h"
 
 #include "GASXAbilityTagRelationshipMap.generated.h"
 
@@ -37,7 +38,22 @@ struct GAMEPLAYABILITYSYSTEMEXTENSION_API FAbilityTagRelationship
 };
 
 
-/** Mapping of how ability tags block or cancel other abilities */
+/** Tags of every relationship that applies to an ability, merged */
+struct FGASXAbilityTagRelationshipTags
+{
+	FGameplayTagContainer CancelAbilitiesWithTag;
+	FGameplayTagContainer BlockAbilitiesWithTag;
+	FGameplayTagContainer ActivationRequiredTags;
+	FGameplayTagContainer ActivationBlockedTags;
+
+	void Append(const FAbilityTagRelationship& Relationship);
+	void Append(const FGASXAbilityTagRelationshipTags& Other);
+};
+
+/**
+ * Mapping of how ability tags block or cancel other abilities
+ * Relationships are compiled on load into a map from AbilityTag to merged tags, and the result for each distinct set of ability tags is cached, so lookups don't iterate relationships.
+ */
 UCLASS()
 class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXAbilityTagRelationshipMap : public UDataAsset
 {
@@ -48,7 +64,46 @@ private:
 	UPROPERTY(EditAnywhere, Category = Ability, meta = (TitleProperty = "AbilityTag"))
 	TArray<FAbilityTagRelationship> AbilityTagRelationships;
 
+	/** Order independent, as FGameplayTagContainer::operator== is */
+	struct FAbilityTagsKeyFuncs : BaseKeyFuncs<TPair<FGameplayTagContainer, FGASXAbilityTagRelationshipTags>, FGameplayTagContainer>
+	{
+		static const FGameplayTagContainer& GetSetKey(const TPair<FGameplayTagContainer, FGASXAbilityTagRelationshipTags>& Element) { return Element.Key; }
+		static bool Matches(const FGameplayTagContainer& A, const FGameplayTagContainer& B) { return A == B; }
+		static uint32 GetKeyHash(const FGameplayTagContainer& Key);
+	};
+
+	// Relationships merged by AbilityTag
+	TMap<FGameplayTag, FGASXAbilityTagRelationshipTags> CompiledRelationships;
+
+	// Merged tags for each distinct set of ability tags looked up so far
+	mutable TMap<FGameplayTagContainer, FGASXAbilityTagRelationshipTags, FDefaultSetAllocator, FAbilityTagsKeyFuncs> CachedAbilityTags;
+
+	bool bCompiled = false;
+
 public:
+	// UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// End of UObject interface
+
+	/** Replaces the relationships, e.g. for a map built at runtime. */
+	void SetAbilityTagRelationships(TArray<FAbilityTagRelationship> InRelationships);
+
+	const TArray<FAbilityTagRelationship>& GetAbilityTagRelationships() const { return AbilityTagRelationships; }
+
+	/**
+	 * Returns the merged tags of every relationship whose AbilityTag is one of AbilityTags or a parent of one.
+	 * The reference is valid until the next lookup with different ability tags.
+	 */
+	const FGASXAbilityTagRelationshipTags& GetRelationshipTags(const FGameplayTagContainer& AbilityTags) const;
+
+	/** Rebuilds the compiled relationships and clears cached lookups. */
+	void CompileRelationships();
+
+	void ClearCachedLookups() const { CachedAbilityTags.Reset(); }
+
 	/** Given a set of ability tags, parse the tag relationship and fill out tags to block and cancel */
 	void GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const;
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AbilitySystemComponent.h"
+#include "Containers/StaticArray.h"
 #include "GASXAbilitySystemComponent.generated.h"
 
 class UGASXAbilityTagRelationshipMap;
@@ -16,6 +17,12 @@ class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXAbilitySystemComponent : public UA
 {
 	GENERATED_BODY()
 
+public:
+	// Presses of OnInputTriggered abilities that fail to activate, e.g. while blocked or on cooldown, are replayed on the first frame the ability can activate within this time.
+	// A release within the window is replayed right after the activation. 0 disables buffering.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (ClampMin = "0.0", Units = "s"))
+	float InputBufferWindow = 0.f;
+
 protected:
 	// If set, this table is used to look up tag relationships for activate and cancel
 	UPROPERTY()
@@ -30,6 +37,45 @@ protected:
 	// Handles to abilities that have their input held.
 	TArray<FGameplayAbilitySpecHandle> InputHeldSpecHandles;
 
+	// Handles to abilities whose press this frame got through, i.e. they activated, or got the input event and don't buffer presses while active. Presses of the others are kept in InputBuffer.
+	TArray<FGameplayAbilitySpecHandle> InputHandledSpecHandles;
+
+	// Incremented whenever an ability is given or removed. See GetAbilitiesGeneration().
+	uint32 AbilitiesGeneration = 1;
+
+	// Incremented whenever owned tags, blocked ability tags or the tag relationship mapping change. See GetOwnedTagsGeneration().
+	uint32 OwnedTagsGeneration = 1;
+
+	struct FIndexedAbilitySpec
+	{
+		// Index into ActivatableAbilities.Items. May be stale after a removal, and is fixed on the next lookup.
+		int32 Index = INDEX_NONE;
+
+		// DynamicAbilityTags the spec is listed under in InputTagToSpecHandles.
+		FGameplayTagContainer InputTags;
+	};
+
+	// Lookups into ActivatableAbilities for the input path, updated when abilities are given or removed and when DynamicAbilityTags change.
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle, TInlineAllocator<2>>> InputTagToSpecHandles;
+	TMap<FGameplayAbilitySpecHandle, FIndexedAbilitySpec> IndexedSpecs;
+
+	struct FBufferedInput
+	{
+		FGameplayTag InputTag;
+		double Time = 0.0;
+		uint64 Frame = 0;
+		bool bPressed = false;
+
+		// Press replayed, superseded by a later press or expired. Releases are never pending.
+		bool bConsumed = true;
+	};
+
+	// Ring of the latest input events when InputBufferWindow > 0. The oldest is overwritten when full.
+	static constexpr int32 InputBufferSize = 16;
+	TStaticArray<FBufferedInput, InputBufferSize> InputBuffer;
+	int32 InputBufferHead = 0;
+	int32 NumPendingBufferedPresses = 0;
+
 public:
 	UGASXAbilitySystemComponent(const FObjectInitializer& ObjectInitializer);
 
@@ -42,15 +88,51 @@ public:
 	/** Looks at ability tags and gathers additional required and blocking tags */
 	void GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const;
 
+	virtual bool ShouldDoServerAbilityRPCBatch() const override { return true; }
 	virtual void ApplyAbilityBlockAndCancelTags(const FGameplayTagContainer& AbilityTags, UGameplayAbility* RequestingAbility, bool bEnableBlockTags, const FGameplayTagContainer& BlockTags, bool bExecuteCancelTags, const FGameplayTagContainer& CancelTags) override;
 
 	void AbilityInputTagPressed(const FGameplayTag& InputTag);
 	void AbilityInputTagReleased(const FGameplayTag& InputTag);
 
 	void ProcessAbilityInput(float DeltaTime, bool bGamePaused);
+
+	// Activates the ability in a server RPC batch, so that activation, target data and end of an instant ability are sent to the server in one RPC.
+	bool TryActivateAbilityBatched(FGameplayAbilitySpecHandle AbilityHandle);
 	void ClearAbilityInput();
 
+	// Changes whenever an ability is given or removed, on both server and clients. Lets callers cache lookups into ActivatableAbilities.
+	uint32 GetAbilitiesGeneration() const { return AbilitiesGeneration; }
+
+	// Changes whenever the result of the ASC part of UGASXGameplayAbility::DoesAbilitySatisfyTagRequirements() may change.
+	uint32 GetOwnedTagsGeneration() const { return OwnedTagsGeneration; }
+
+	// Like FindAbilitySpecFromHandle() but without searching ActivatableAbilities.
+	FGameplayAbilitySpec* FindAbilitySpecFromHandleIndexed(FGameplayAbilitySpecHandle Handle);
+
+	// Call this after changing DynamicAbilityTags of a given spec. Changes replicated to clients are picked up by OnRep_ActivateAbilities().
+	void UpdateAbilitySpecInputTags(const FGameplayAbilitySpec& AbilitySpec);
+
 protected:
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRep_ActivateAbilities() override;
+
+	// Bumps OwnedTagsGeneration. Bound to the generic tag events of both owned and blocked ability tags.
+	void OnOwnedOrBlockedTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	void BufferInput(const FGameplayTag& InputTag, bool bPressed);
+
+	// Tries to activate abilities for pending buffered presses. Called at the end of ProcessAbilityInput().
+	void ReplayBufferedInput();
+
+	// Adds or updates the index of AbilitySpec, which is at Index in ActivatableAbilities.Items.
+	void IndexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec, int32 Index);
+	void UnindexAbilitySpec(FGameplayAbilitySpecHandle Handle);
+	void RemoveInputTagSpecHandle(const FGameplayTag& InputTag, FGameplayAbilitySpecHandle Handle);
+
+	// Moves the spec between InputTagToSpecHandles lists if its DynamicAbilityTags differ from IndexedSpec.InputTags.
+	void UpdateIndexedInputTags(const FGameplayAbilitySpec& AbilitySpec, FIndexedAbilitySpec& IndexedSpec);
+
 	virtual void AbilitySpecInputPressed(FGameplayAbilitySpec& Spec) override;
 	virtual void AbilitySpecInputReleased(FGameplayAbilitySpec& Spec) override;
 };
@@ -31,8 +31,8 @@ public:
 	////////////////////
 	///// Target Type
 
-	UFUNCTION(BlueprintCallable, Category = Ability)
-	static void GetTargetTypeTargets(TSubclassOf<class UGASXTargetType> TargetType, FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors);
+	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "ActorInfo,EventData"))
+	static void GetTargetTypeTargets(TSubclassOf<class UGASXTargetType> TargetType, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors);
 	
 	////////////////////
 	///// Attribute Set Initializer
@@ -46,6 +46,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Ability)
 	static bool IsTargetDataValidForInteraction(const FGameplayAbilityTargetDataHandle& InTargetData, TArray<AActor*> IgnoreActors, bool bChecksAvailability = true);
 
+	// Native version of IsTargetDataValidForInteraction() for a single hit, which doesn't copy the hit or the ignored actors.
+	static bool IsHitResultValidForInteraction(const FHitResult& HitResult, const AActor* IgnoreActor, bool bChecksAvailability = true);
+
+	// Uses UGASXInteractableComponent if the actor has one, IGASXInteractable otherwise.
+	UFUNCTION(BlueprintCallable, Category = Ability)
+	static bool IsAvailableForInteraction(AActor* InteractableActor, UPrimitiveComponent* InteractableComponent);
+
+	// Uses UGASXInteractableComponent if the actor has one, IGASXInteractable otherwise.
+	UFUNCTION(BlueprintCallable, Category = Ability)
+	static float GetInteractionDuration(AActor* InteractableActor, UPrimitiveComponent* InteractableComponent);
+
 	////////////////////
 	///// Effect Container
 
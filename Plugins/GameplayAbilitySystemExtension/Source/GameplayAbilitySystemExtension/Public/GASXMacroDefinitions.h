@@ -3,6 +3,21 @@
 #pragma once
 
 #include "Logging/LogMacros.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 GAMEPLAYABILITYSYSTEMEXTENSION_API DECLARE_LOG_CATEGORY_EXTERN(LogGASX, Log, All);
 GAMEPLAYABILITYSYSTEMEXTENSION_API DECLARE_LOG_CATEGORY_EXTERN(LogGASXExperience, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("GASX Targeting"), STATGROUP_GASXTargeting, STATCAT_Advanced);
+DECLARE_STATS_GROUP(TEXT("GASX Interaction"), STATGROUP_GASXInteraction, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GAMEPLAYABILITYSYSTEMEXTENSION_API, GASXInteraction);
+
+// Counts interaction work for both "stat GASXInteraction" and the CSV profiler. Stat is declared as STAT_GASXInteraction##Name in the calling file.
+#define GASX_INTERACTION_COUNT(Name, Amount) \
+	do \
+	{ \
+		INC_DWORD_STAT_BY(STAT_GASXInteraction##Name, Amount); \
+		CSV_CUSTOM_STAT(GASXInteraction, Name, (int32)(Amount), ECsvCustomStatOp::Accumulate); \
+	} while (0)
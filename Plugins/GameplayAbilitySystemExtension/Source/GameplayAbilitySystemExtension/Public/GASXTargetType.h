@@ -8,11 +8,17 @@
 #include "GASXDataTypes.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Abilities/GameplayAbilityTargetDataFilter.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "WorldCollision.h"
 #include "GASXTargetType.generated.h"
 
 class AActor;
 struct FGameplayEventData;
 
+/** Executed with the results of UGASXTargetType::GetTargetsAsync() */
+DECLARE_DELEGATE_TwoParams(FGASXTargetsReadyDelegate, const TArray<FHitResult>& /*HitResults*/, const TArray<AActor*>& /*Actors*/);
+
 UENUM(BlueprintType)
 enum class ESceneObjectType : uint8
 {
@@ -46,6 +52,15 @@ enum class EGASXTraceHitType : uint8
 	THT_MultiTrace		UMETA(DisplayName = "Multi")
 };
 
+UENUM(BlueprintType)
+enum class EGASXTargetPriority : uint8
+{
+	TP_None				UMETA(DisplayName = "None"),			// Keep trace order
+	TP_Distance			UMETA(DisplayName = "Distance"),		// Closest to trace start first
+	TP_AngleToForward	UMETA(DisplayName = "AngleToForward"),	// Closest to trace direction first
+	TP_Custom			UMETA(DisplayName = "Custom")			// Uses ScoreHitCustom()
+};
+
 UENUM(BlueprintType)
 enum class EFilterActorType : uint8
 {
@@ -54,12 +69,81 @@ enum class EFilterActorType : uint8
 	FAT_AvatarActor		UMETA(DisplayName = "AvatarActor")
 };
 
+/**
+ * Collision query data resolved from target type settings.
+ * Built once when the settings are loaded or edited so that queries don't have to rebuild params or convert channels on every call.
+ */
+struct FGASXCollisionQuery
+{
+	EGASXTraceTargetType TargetType = EGASXTraceTargetType::TTT_ByChannel;
+	ECollisionChannel Channel = ECC_Visibility;
+	FName ProfileName;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	FCollisionQueryParams QueryParams;
+	FCollisionShape Shape;
+	FQuat ShapeRotation = FQuat::Identity;
+	bool bIsLineTrace = true;
+};
+
+/**
+ * FGameplayTargetDataFilter resolved into plain data.
+ * Built once per target type so that filtering doesn't allocate a filter handle or go through virtual calls per actor.
+ */
+struct FGASXCompiledTargetFilter
+{
+	ETargetDataFilterSelf::Type SelfFilter = ETargetDataFilterSelf::TDFS_Any;
+	const UClass* RequiredActorClass = nullptr;
+	bool bReverseFilter = false;
+
+	void Compile(const FGameplayTargetDataFilter& Filter)
+	{
+		SelfFilter = Filter.SelfFilter;
+		RequiredActorClass = Filter.RequiredActorClass.Get();
+		bReverseFilter = Filter.bReverseFilter;
+	}
+
+	// Same result as FGameplayTargetDataFilterHandle::FilterPassesForActor() with SelfActor as the filter context.
+	FORCEINLINE bool PassesForActor(const AActor* Actor, const AActor* SelfActor) const
+	{
+		// Filter handles never let nullptr through, even if the filter is reversed.
+		if (!Actor)
+		{
+			return false;
+		}
+
+		switch (SelfFilter)
+		{
+		case ETargetDataFilterSelf::TDFS_NoOthers:
+			if (Actor != SelfActor) return bReverseFilter;
+			break;
+		case ETargetDataFilterSelf::TDFS_NoSelf:
+			if (Actor == SelfActor) return bReverseFilter;
+			break;
+		case ETargetDataFilterSelf::TDFS_Any:
+		default:
+			break;
+		}
+
+		if (RequiredActorClass && !Actor->IsA(RequiredActorClass))
+		{
+			return bReverseFilter;
+		}
+		return !bReverseFilter;
+	}
+};
+
+/** Scratch buffer for actors to ignore. Queries usually ignore only a few actors, so this rarely allocates. */
+using FGASXActorsToIgnoreArray = TArray<AActor*, TInlineAllocator<4>>;
+
 /**
  * Class that is used to determine targeting for abilities
  * It is meant to be blueprinted to run target logic
  * This does not subclass GameplayAbilityTargetActor because this class is never instanced into the world
  * This can be used as a basis for a game-specific targeting blueprint
  * If your targeting is more complicated you may need to instance into the world once or as a pooled actor
+ *
+ * Native code should call the Dispatch* functions. They only go through the Blueprint native events if a Blueprint overrides them,
+ * and call the Native* functions with const references otherwise. C++ subclasses should override the Native* functions.
  */
 UCLASS(Abstract, Blueprintable, meta = (ShowWorldContextPin))
 class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType : public UObject
@@ -67,8 +151,8 @@ class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType : public UObject
 	GENERATED_BODY()
 
 public:
-	// Filter for GetTargets()
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Filter")
+	// Filter for GetTargets(). Resolved into CompiledFilter on load and on edit, so it's read only in Blueprint.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Filter")
 	FGameplayTargetDataFilter Filter;
 
 	// Determins FilterActor parameter for Filter
@@ -78,13 +162,29 @@ public:
 	// If true, OutHitResults parameter in GetTargets() will be filtered as well as OutActors.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Filter")
 	bool bFilterHitResults = true;
+
+	// If true, GetTargetsCached() reuses targets found earlier in the same frame for the same avatar and event data.
+	// Only enable this if targets can't change within a frame. Cached targets don't follow an avatar that moved or targets killed or moved by effects applied in between.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType")
+	bool bAllowFrameCache = false;
 	
 public:
 	// Constructor and overrides
 	UGASXTargetType() {}
 
+	// UObject interface
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// End of UObject interface
+
+	// Resolves Filter into CompiledFilter. Call this if you change Filter at runtime.
+	void CompileFilter();
+
 	UFUNCTION(BlueprintPure, Category = "GASXTargetType")
-	UObject* GetWorldContextObjectFromActorInfo(FGameplayAbilityActorInfo ActorInfo) const;
+	UObject* GetWorldContextObjectFromActorInfo(const FGameplayAbilityActorInfo& ActorInfo) const;
 	
 	// Returns FilterActor for Filter depending on FilterActorType 
 	UFUNCTION(BlueprintNativeEvent, Category = "GASXTargetType|Filter")
@@ -104,6 +204,54 @@ public:
 	/** Called to determine targets to apply gameplay effects to */
 	UFUNCTION(BlueprintNativeEvent, Category = "GASXTargetType")
 	void GetTargets(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
+
+	/**
+	 * Deferred version of GetTargets(). OnTargetsReady is executed on the game thread next frame.
+	 * By default this runs GetTargets() right away and only defers the result. Trace types issue async scene queries instead.
+	 * Returns the handle of the async trace, or an invalid handle if no async trace was issued.
+	 */
+	virtual FTraceHandle GetTargetsAsync(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXTargetsReadyDelegate OnTargetsReady) const;
+
+	// Calls GetFilterActor() if it's overridden in Blueprint, NativeGetFilterActor() otherwise.
+	AActor* DispatchGetFilterActor(const FGameplayAbilityActorInfo& ActorInfo) const;
+
+	// Calls MakeFilterHandle() if it's overridden in Blueprint, NativeMakeFilterHandle() otherwise.
+	FGameplayTargetDataFilterHandle DispatchMakeFilterHandle(const FGameplayAbilityActorInfo& ActorInfo) const;
+
+	// Calls FilterTargets() if it's overridden in Blueprint, NativeFilterTargets() otherwise.
+	void DispatchFilterTargets(const FGameplayAbilityActorInfo& ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const;
+
+	// Calls GetTargets() if it's overridden in Blueprint, NativeGetTargets() otherwise.
+	void DispatchGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
+
+	/**
+	 * Same as DispatchGetTargets(), but targets are memoized for the rest of the frame.
+	 * The cache is keyed by target type class, avatar actor and event data, so several effect containers sharing a target type run targeting only once.
+	 * Only used if bAllowFrameCache is set. See also gasx.targeting.FrameCache.
+	 */
+	void GetTargetsCached(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
+
+protected:
+	// Native versions of the Blueprint native events above. The _Implementation functions call these.
+	virtual AActor* NativeGetFilterActor(const FGameplayAbilityActorInfo& ActorInfo) const;
+	virtual FGameplayTargetDataFilterHandle NativeMakeFilterHandle(const FGameplayAbilityActorInfo& ActorInfo) const;
+	virtual void NativeFilterTargets(const FGameplayAbilityActorInfo& ActorInfo, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const;
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
+
+	// Caches which Blueprint native events are overridden in Blueprint. Called from PostInitProperties() and PostLoad().
+	virtual void CacheBlueprintOverrides();
+
+	// Filter compiled by CompileFilter(). Used unless MakeFilterHandle() is overridden in Blueprint.
+	FGASXCompiledTargetFilter CompiledFilter;
+
+	// True if DispatchFilterTargets() only runs CompiledFilter, so targets can be tested against it before filtering.
+	bool IsFilterCompiled() const { return !bBlueprintFilterTargets && !bBlueprintMakeFilterHandle; }
+
+private:
+	bool bBlueprintGetFilterActor = false;
+	bool bBlueprintMakeFilterHandle = false;
+	bool bBlueprintFilterTargets = false;
+	bool bBlueprintGetTargets = false;
 };
 
 /** Trivial target type that uses the owner actor */
@@ -116,8 +264,9 @@ public:
 	// Constructor and overrides
 	UGASXTargetType_UseOwner() {}
 
+protected:
 	/** Uses the passed in event data */
-	virtual void GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
 };
 
 /** Trivial target type that uses the avatar actor */
@@ -130,8 +279,9 @@ public:
 	// Constructor and overrides
 	UGASXTargetType_UseAvatar() {}
 
+protected:
 	/** Uses the passed in event data */
-	virtual void GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
 };
 
 /** Trivial target type that pulls the target out of the event data */
@@ -144,8 +294,9 @@ public:
 	// Constructor and overrides
 	UGASXTargetType_UseEventData() {}
 
+protected:
 	/** Uses the passed in event data */
-	virtual void GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
 };
 
 /** Trivial target type that pulls targets with a sphere trace */
@@ -156,39 +307,39 @@ class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_TraceBase : public UGAS
 
 public:
 	// trace by channel, profile, or object types?
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|TargetSettings")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|TargetSettings")
 	EGASXTraceTargetType TraceTargetType = EGASXTraceTargetType::TTT_ByChannel;
 
 	// used for trace if TraceTargetType is set to TTT_ByChannel
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByChannel"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByChannel"))
 	TEnumAsByte<ETraceTypeQuery> TraceChannel = ETraceTypeQuery::TraceTypeQuery1;
 
 	// used for trace if TraceTargetType is set to TTT_ByProfile
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByProfile"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByProfile"))
 	FCollisionProfileName ProfileName;
 
 	// used for trace if TraceTargetType is set to TTT_ByObjectTypes
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByObjectTypes"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|TargetSettings", meta = (EditCondition = "TraceTargetType == EGASXTraceTargetType::TTT_ByObjectTypes"))
 	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
 
 	// trace shape type: line, sphere, capsule or box
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|ShapeSettings")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|ShapeSettings")
 	EGASXTraceShapeType TraceShapeType = EGASXTraceShapeType::TST_LineTrace;
 
 	// for sphere trace and capsule trace
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_SphereTrace || TraceShapeType == EGASXTraceShapeType::TST_CapsuleTrace"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_SphereTrace || TraceShapeType == EGASXTraceShapeType::TST_CapsuleTrace"))
 	float TraceRadius = 0.f;
 
 	// for capsule trace
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_CapsuleTrace"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_CapsuleTrace"))
 	float CapsuleTraceHalfHeight = 0.f;
 
 	// for box trace
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_BoxTrace"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_BoxTrace"))
 	FVector BoxTraceHalfSize = FVector(0.f, 0.f, 0.f);
 
 	// for box trace
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_BoxTrace"))
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace|ShapeSettings", meta = (EditCondition = "TraceShapeType == EGASXTraceShapeType::TST_BoxTrace"))
 	FRotator BoxTraceOrientation = FRotator(0.f, 0.f, 0.f);
 
 	// single or multi trace
@@ -203,9 +354,36 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace")
 	bool bHitActorsAsTargets = true;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Trace")
 	bool bTraceComplex = false;
 
+	// Max number of targets taken from a trace. 0 means no limit. Hits are ranked by TargetPriority and only the best ones are kept.
+	// Targets removed by Filter don't count.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|Budget", meta = (ClampMin = "0"))
+	int32 MaxTargets = 0;
+
+	// How hits are ranked when there are more than MaxTargets.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|Budget")
+	EGASXTargetPriority TargetPriority = EGASXTargetPriority::TP_None;
+
+	// Server only. If true, actors tracked by UGASXLagCompensationSubsystem are hit where they were at GetRewindTimestamp(), instead of where they are now.
+	// Only applies to remote players. The listen server host and AI are not rewound.
+	// Rewound actors are approximated by their simple collision capsule, and trace shapes by a sphere. Async traces run synchronously when this applies.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|LagCompensation")
+	bool bLagCompensate = false;
+
+	// Added to the one way latency when rewinding, e.g. the interpolation delay of simulated proxies on clients.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|LagCompensation", meta = (EditCondition = "bLagCompensate", ClampMin = "0.0", Units = "s"))
+	float RewindInterpolationDelay = 0.1f;
+
+	// Targets are never rewound further than this.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|LagCompensation", meta = (EditCondition = "bLagCompensate", ClampMin = "0.0", Units = "s"))
+	float MaxRewindTime = 0.4f;
+
+	// Max traces run to find level geometry behind tracked actors that blocked the trace. Rewound actors behind that geometry are not hit.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|LagCompensation", meta = (EditCondition = "bLagCompensate", ClampMin = "0"))
+	int32 MaxOcclusionTraces = 4;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|Debug")
 	TEnumAsByte<EDrawDebugTrace::Type> DrawDebugType = EDrawDebugTrace::Type::None;
 
@@ -218,17 +396,29 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace|Debug")
 	float DebugDrawTime = 5.f;
 
+protected:
+	// Query data built from the trace settings above. See BuildCollisionQuery().
+	FGASXCollisionQuery CollisionQuery;
+
 public:
 	// Constructor and overrides
 	UGASXTargetType_TraceBase() {}
 
+	// UObject interface
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// End of UObject interface
+
 	// Gets an object from ActorInfo with SceneObjectType
 	UFUNCTION(BlueprintPure, Category = "GASXTargetType|Trace")
-	UObject* GetSceneObject(FGameplayAbilityActorInfo ActorInfo) const;
+	UObject* GetSceneObject(const FGameplayAbilityActorInfo& ActorInfo) const;
 
 	// Gets transform of an object from ActorInfo with SceneObjectType
 	UFUNCTION(BlueprintPure, Category = "GASXTargetType|Trace")
-	FTransform GetSceneObjectTransform(FGameplayAbilityActorInfo ActorInfo) const;
+	FTransform GetSceneObjectTransform(const FGameplayAbilityActorInfo& ActorInfo) const;
 
 	// Calculates trance start and end location.
 	UFUNCTION(BlueprintNativeEvent, Category = "GASXTargetType|Trace")
@@ -238,8 +428,76 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Category = "GASXTargetType|Trace")
 	TArray<AActor*> GetActorsToIgnore(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData) const;
 
+	/** Issues an async scene query so that physics can run it in parallel. Results are filtered the same way as GetTargets(). */
+	virtual FTraceHandle GetTargetsAsync(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXTargetsReadyDelegate OnTargetsReady) const override;
+
+	// Resolves trace settings into CollisionQuery. Called on load and on edit, so trace settings are read only in Blueprint.
+	// C++ code changing trace settings at runtime has to call this itself.
+	void BuildCollisionQuery();
+
+	// Calls GetTraceStartAndEnd() if it's overridden in Blueprint, NativeGetTraceStartAndEnd() otherwise.
+	void DispatchGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const;
+
+	// Calls GetActorsToIgnore() if it's overridden in Blueprint, NativeGetActorsToIgnore() otherwise. Actors are appended to OutActors.
+	void DispatchGetActorsToIgnore(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXActorsToIgnoreArray& OutActors) const;
+
+protected:
+	virtual void NativeGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const;
+	virtual void NativeGetActorsToIgnore(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FGASXActorsToIgnoreArray& OutActors) const;
+
 	/** Uses the passed in event data */
-	virtual void GetTargets_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+
+	virtual void CacheBlueprintOverrides() override;
+
+	// Score of a hit for TP_Custom. Higher is better.
+	virtual float ScoreHitCustom(const FGameplayAbilityActorInfo& ActorInfo, const FHitResult& Hit, const FVector& TraceStart, const FVector& TraceDirection) const { return 0.f; }
+
+	// Score of a hit according to TargetPriority. Higher is better.
+	float ScoreHit(const FGameplayAbilityActorInfo& ActorInfo, const FHitResult& Hit, const FVector& TraceStart, const FVector& TraceDirection) const;
+
+	// Keeps the best MaxTargets hits that pass the compiled filter. If bActorsAsTargets, hit actors are moved to OutActors without duplicates and InOutHitResults is emptied.
+	// If the filter is not compiled, every hit is kept in ranked order, and TrimToMaxTargets() has to be called after filtering.
+	void SelectTargets(const FGameplayAbilityActorInfo& ActorInfo, const FVector& Start, const FVector& End, bool bActorsAsTargets, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& OutActors) const;
+
+	// Cuts filtered targets down to MaxTargets.
+	void TrimToMaxTargets(bool bActorsAsTargets, TArray<FHitResult>& InOutHitResults, TArray<AActor*>& InOutActors) const;
+
+	// True if the avatar is controlled by a player on a remote client.
+	static bool IsRemotePlayer(const FGameplayAbilityActorInfo& ActorInfo);
+
+	// True if bLagCompensate is set and this is the server running targeting for a remote player.
+	bool ShouldLagCompensate(const FGameplayAbilityActorInfo& ActorInfo) const;
+
+	// World time the client saw when it activated the ability. By default, now minus half the round trip time and RewindInterpolationDelay for remote players, and now otherwise.
+	virtual double GetRewindTimestamp(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData) const;
+
+	// Replaces hits on actors tracked by UGASXLagCompensationSubsystem with hits on their rewound capsules, up to the first level geometry. Returns true if there is a blocking hit.
+	bool ApplyLagCompensation(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, TArray<FHitResult>& InOutHitResults) const;
+
+	// Builds query params for a trace, ignoring actors from DispatchGetActorsToIgnore().
+	void MakeQueryParams(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FCollisionQueryParams& OutQueryParams) const;
+
+	// Runs the scene query described by CollisionQuery. Returns true if there was a blocking hit.
+	bool PerformTrace(const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, TArray<FHitResult>& OutHitResults) const;
+
+	// Single hit version of PerformTrace(), regardless of TraceHitType and without debug drawing.
+	bool PerformSingleTrace(const UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, FHitResult& OutHitResult) const;
+
+	// Async version of PerformTrace(). TraceDelegate is executed next frame.
+	FTraceHandle PerformAsyncTrace(UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& QueryParams, const FTraceDelegate& TraceDelegate) const;
+
+	// Turns async trace results into targets and hands them over to OnTargetsReady.
+	void OnAsyncTraceCompleted(FTraceDatum& TraceDatum, const FGameplayAbilityActorInfo& ActorInfo, const FGASXTargetsReadyDelegate& OnTargetsReady) const;
+
+#if ENABLE_DRAW_DEBUG
+	void DrawDebugTraceSingle(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const FHitResult& HitResult) const;
+	void DrawDebugTraceMulti(const UWorld* World, const FVector& Start, const FVector& End, bool bHit, const TArray<FHitResult>& HitResults) const;
+#endif
+
+private:
+	bool bBlueprintGetTraceStartAndEnd = false;
+	bool bBlueprintGetActorsToIgnore = false;
 };
 
 /** Trivial target type that pulls targets with a sphere trace from avatar actor to actor forward. */
@@ -255,6 +513,230 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Trace")
 	float TraceLength = 1.f;
 
+protected:
+	virtual void NativeGetTraceStartAndEnd(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, FVector& OutStart, FVector& OutEnd) const override;
+};
+/**
+ * Candidate filter used by overlap target types, in the space of the query origin.
+ * Values that are not used are set so that they always pass.
+ */
+struct FGASXCandidateFilter
+{
+	float MaxDistanceSquared = MAX_flt;
+	float MinHeight = -MAX_flt;
+	float MaxHeight = MAX_flt;
+	// Cosine of the half angle around the origin forward. -2 disables the angle test.
+	float CosHalfAngle = -2.f;
+};
+
+/**
+ * Base of target types that run one overlap query around a scene object and then filter candidate actors by distance, height band and angle.
+ * Candidate positions are packed into arrays and filtered 4 at a time with vector math, which is much cheaper than chaining traces to approximate a shape.
+ * Overlap target types only output actors.
+ */
+UCLASS(Abstract)
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_OverlapBase : public UGASXTargetType
+{
+	GENERATED_BODY()
+
+public:
+	// overlap by channel, profile, or object types?
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|TargetSettings")
+	EGASXTraceTargetType OverlapTargetType = EGASXTraceTargetType::TTT_ByChannel;
+
+	// used for overlap if OverlapTargetType is set to TTT_ByChannel
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|TargetSettings", meta = (EditCondition = "OverlapTargetType == EGASXTraceTargetType::TTT_ByChannel"))
+	TEnumAsByte<ETraceTypeQuery> TraceChannel = ETraceTypeQuery::TraceTypeQuery1;
+
+	// used for overlap if OverlapTargetType is set to TTT_ByProfile
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|TargetSettings", meta = (EditCondition = "OverlapTargetType == EGASXTraceTargetType::TTT_ByProfile"))
+	FCollisionProfileName ProfileName;
+
+	// used for overlap if OverlapTargetType is set to TTT_ByObjectTypes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|TargetSettings", meta = (EditCondition = "OverlapTargetType == EGASXTraceTargetType::TTT_ByObjectTypes"))
+	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
+
+	// The scene object the query is centered on and oriented to.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap")
+	ESceneObjectType SceneObjectType = ESceneObjectType::SOT_AvatarActor;
+
+	// Offset from the scene object, in its local space.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap")
+	FVector OriginOffset = FVector(0.f, 0.f, 0.f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap")
+	bool bIgnoreAvatarActor = true;
+
+	// If true, only actors between MinHeight and MaxHeight along the origin up axis are targeted.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|HeightBand")
+	bool bFilterByHeight = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|HeightBand", meta = (EditCondition = "bFilterByHeight"))
+	float MinHeight = -100.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap|HeightBand", meta = (EditCondition = "bFilterByHeight"))
+	float MaxHeight = 100.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap|Debug")
+	TEnumAsByte<EDrawDebugTrace::Type> DrawDebugType = EDrawDebugTrace::Type::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap|Debug")
+	FLinearColor DebugShapeColor = FLinearColor::Red;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Overlap|Debug")
+	float DebugDrawTime = 5.f;
+
+protected:
+	// Query data built from the settings. See BuildOverlapQuery().
+	FGASXCollisionQuery CollisionQuery;
+
+	// Candidate filter built from the settings. See BuildOverlapQuery().
+	FGASXCandidateFilter CandidateFilter;
+
+public:
+	// Constructor and overrides
+	UGASXTargetType_OverlapBase() {}
+
+	// UObject interface
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// End of UObject interface
+
+	// Gets the transform the query is centered on, including OriginOffset.
+	UFUNCTION(BlueprintPure, Category = "GASXTargetType|Overlap")
+	FTransform GetOverlapOrigin(const FGameplayAbilityActorInfo& ActorInfo) const;
+
+	// Resolves settings into CollisionQuery and CandidateFilter. Subclasses set the shape and their part of the filter.
+	// Called on load and on edit, so the settings it reads are read only in Blueprint. C++ code changing them at runtime has to call this itself.
+	virtual void BuildOverlapQuery();
+
+protected:
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+
+	// Runs the broad overlap query, appending unique overlapped actors to OutActors.
+	void PerformOverlap(const UWorld* World, const FTransform& Origin, const FCollisionQueryParams& QueryParams, TArray<AActor*>& OutActors) const;
+
+	// Removes actors that don't pass CandidateFilter, keeping the order of the rest.
+	void FilterCandidates(const FTransform& Origin, TArray<AActor*>& InOutActors) const;
+
+#if ENABLE_DRAW_DEBUG
+	virtual void DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const {}
+
+	// Common arguments for debug draw helpers
+	bool IsDebugPersistent() const { return DrawDebugType == EDrawDebugTrace::Persistent; }
+	float GetDebugLifeTime() const { return DrawDebugType == EDrawDebugTrace::ForDuration ? DebugDrawTime : 0.f; }
+#endif
+};
+
+/** Targets actors within a sphere around the origin. */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_OverlapSphere : public UGASXTargetType_OverlapBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap", meta = (ClampMin = "0"))
+	float Radius = 300.f;
+
+protected:
+	virtual void BuildOverlapQuery() override;
+#if ENABLE_DRAW_DEBUG
+	virtual void DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const override;
+#endif
+};
+
+/** Targets actors within a box oriented to the origin. */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_OverlapBox : public UGASXTargetType_OverlapBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap")
+	FVector BoxHalfExtent = FVector(100.f, 100.f, 100.f);
+
+	// Box rotation relative to the origin
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap")
+	FRotator BoxOrientation = FRotator(0.f, 0.f, 0.f);
+
+protected:
+	virtual void BuildOverlapQuery() override;
+#if ENABLE_DRAW_DEBUG
+	virtual void DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const override;
+#endif
+};
+
+/** Targets actors within a cone along the origin forward, e.g. for cleaves and breath attacks. */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_Cone : public UGASXTargetType_OverlapBase
+{
+	GENERATED_BODY()
+
 public:
-	void GetTraceStartAndEnd_Implementation(FGameplayAbilityActorInfo ActorInfo, FGameplayEventData EventData, FVector& OutStart, FVector& OutEnd) const override;
-};
\ No newline at end of file
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap", meta = (ClampMin = "0"))
+	float Range = 500.f;
+
+	// Angle between the cone axis and its side, in degrees.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "GASXTargetType|Overlap", meta = (ClampMin = "0", ClampMax = "180"))
+	float HalfAngle = 45.f;
+
+protected:
+	virtual void BuildOverlapQuery() override;
+#if ENABLE_DRAW_DEBUG
+	virtual void DrawDebugOverlap(const UWorld* World, const FTransform& Origin) const override;
+#endif
+};
+
+UENUM(BlueprintType)
+enum class EGASXHitboxQueryShape : uint8
+{
+	HQS_Ray		UMETA(DisplayName = "Ray"),
+	HQS_Sphere	UMETA(DisplayName = "Sphere"),
+	HQS_Cone	UMETA(DisplayName = "Cone")
+};
+
+/**
+ * Target type that tests against hitbox capsules registered with UGASXHitboxSubsystem (see UGASXHitboxComponent), instead of the physics scene.
+ * Queries start at the scene object and go along its forward. One hit result is made per actor, for its closest capsule.
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXTargetType_Hitbox : public UGASXTargetType
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox")
+	EGASXHitboxQueryShape QueryShape = EGASXHitboxQueryShape::HQS_Ray;
+
+	// The scene object the query starts from.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox")
+	ESceneObjectType SceneObjectType = ESceneObjectType::SOT_AvatarActor;
+
+	// Offset from the scene object, in its local space.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox")
+	FVector OriginOffset = FVector(0.f, 0.f, 0.f);
+
+	// Length of the ray, sphere sweep or cone. A sphere with range 0 is an overlap at the origin.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox", meta = (ClampMin = "0"))
+	float Range = 1000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox", meta = (ClampMin = "0", EditCondition = "QueryShape == EGASXHitboxQueryShape::HQS_Sphere"))
+	float Radius = 50.f;
+
+	// Angle between the cone axis and its side, in degrees.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox", meta = (ClampMin = "0", ClampMax = "180", EditCondition = "QueryShape == EGASXHitboxQueryShape::HQS_Cone"))
+	float HalfAngle = 30.f;
+
+	// if true, hit actors are set to OutActors in GetTargets function, ensuring no duplicates.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox")
+	bool bHitActorsAsTargets = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GASXTargetType|Hitbox")
+	bool bIgnoreAvatarActor = true;
+
+protected:
+	virtual void NativeGetTargets(const FGameplayAbilityActorInfo& ActorInfo, const FGameplayEventData& EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+};
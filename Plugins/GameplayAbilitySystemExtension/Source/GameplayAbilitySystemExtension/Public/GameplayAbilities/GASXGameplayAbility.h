@@ -60,6 +60,17 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability")
 	EGASXAbilityActivationPolicy ActivationPolicy;
 
+	// If true, a press while this OnInputTriggered ability is active is buffered (see UGASXAbilitySystemComponent::InputBufferWindow) and activates it again once it ends,
+	// e.g. for the next attack of a combo. The ability gets the input event either way. Turn this off if the ability handles presses while active itself, e.g. with WaitInputPress.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability", meta = (EditCondition = "ActivationPolicy == EGASXAbilityActivationPolicy::OnInputTriggered"))
+	bool bBufferInputWhileActive = true;
+
+	// Result of the ASC part of DoesAbilitySatisfyTagRequirements(), valid while OwnedTagsGeneration of the ASC doesn't change. Instances only, as the CDO is shared by every ASC.
+	mutable TWeakObjectPtr<const class UGASXAbilitySystemComponent> TagRequirementsCacheASC;
+	mutable uint32 TagRequirementsCacheGeneration = 0;
+	mutable bool bTagRequirementsCacheBlocked = false;
+	mutable bool bTagRequirementsCacheMissing = false;
+
 
 public:
 	UGASXGameplayAbility();
@@ -83,6 +94,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "EventData"))
 	virtual FGASXGameplayEffectContainerSpec MakeEffectContainerSpecFromContainer(const FGASXGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
 
+	/** Make gameplay effect container spec without running targeting logic. Use this when targets are added later, e.g. by UGASXAbilityTask_WaitEffectContainerTargets. */
+	UFUNCTION(BlueprintCallable, Category = Ability)
+	virtual FGASXGameplayEffectContainerSpec MakeEffectContainerSpecWithoutTargets(const FGASXGameplayEffectContainer& Container, int32 OverrideGameplayLevel = -1);
+
 	/** Search for and make a gameplay effect container spec to be applied later, from the EffectContainerMap. This also runs targeting logic if the matched effect container has a target type. */
 	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "EventData"))
 	virtual FGASXGameplayEffectContainerSpec MakeEffectContainerSpec(FGameplayTag ContainerTag, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
@@ -91,6 +106,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Ability)
 	virtual TArray<FActiveGameplayEffectHandle> ApplyEffectContainerSpec(const FGASXGameplayEffectContainerSpec& ContainerSpec);
 
+	/**
+	 * Sends target data from the owning client to the server, e.g. targets found by MakeEffectContainerSpec(). Does nothing on the server.
+	 * Called within ActivateAbility() of an ability activated by input, it's sent in the same RPC as the activation. See UGASXAbilitySystemComponent::TryActivateAbilityBatched().
+	 */
+	UFUNCTION(BlueprintCallable, Category = Ability)
+	virtual void SendTargetDataToServer(const FGameplayAbilityTargetDataHandle& TargetData, FGameplayTag ApplicationTag);
+
 	/** Applies a gameplay effect container, by creating and then applying the spec. This also runs targeting logic if the matched effect container has a target type.*/
 	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "EventData"))
 	virtual TArray<FActiveGameplayEffectHandle> ApplyEffectContainer(FGameplayTag ContainerTag, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
@@ -98,8 +120,16 @@ public:
 	UFUNCTION(BlueprintPure, Category = Ability)
 	EGASXAbilityActivationPolicy GetActivationPolicy() const { return ActivationPolicy; }
 
+	bool ShouldBufferInputWhileActive() const { return bBufferInputWhileActive; }
+
 	void TryActivateAbilityOnSpawn(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) const;
 
+	/**
+	 * Sends Payload as each of EventTags in order, like SendGameplayEvent() but in a single prediction window.
+	 * Payload is shared by reference instead of being copied for each event. Only its EventTag is changed.
+	 */
+	void SendGameplayEvents(TConstArrayView<FGameplayTag> EventTags, FGameplayEventData& Payload);
+
 protected:
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable, Category = Ability, meta = (DisplayName = "On Input Pressed"))
 	void InputPressed_BP();
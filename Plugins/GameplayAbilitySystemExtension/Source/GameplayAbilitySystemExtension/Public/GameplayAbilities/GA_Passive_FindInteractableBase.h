@@ -36,6 +36,42 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Ability|FindInteractable")
 	float TimerPeriod;
 
+	// If true, scans are scheduled by UGASXInteractionSubsystem so that they are spread across frames under a time budget, instead of by a timer of this ability.
+	// Scans may then run later than TimerPeriod when the budget is used up.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable")
+	bool bUseScanScheduler;
+
+	// If true, only the owning client (or the server for avatars it controls, e.g. AI) looks for targets. The server doesn't scan for remote players,
+	// and GA_PerformInteractBase validates the target the client chose instead (see GA_PerformInteractBase::bValidateClientTarget).
+	// Found and lost events are then only sent on the owning client.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable")
+	bool bScanOnOwningClientOnly;
+
+	// If true, the last result is reused without a scan while the avatar view doesn't move and the target is static and still available,
+	// and the scan period follows the distance to the nearest interactable: AdaptiveMaxPeriod if the registry finds none within AdaptiveCoarseRadius, down to AdaptiveMinPeriod when one is very close.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive")
+	bool bAdaptiveScan;
+
+	// The last result is reused while the view point moved less than this since the last scan.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive", meta = (EditCondition = "bAdaptiveScan", ClampMin = "0.0", Units = "cm"))
+	float AdaptiveMoveThreshold;
+
+	// The last result is reused while the view direction rotated less than this since the last scan.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive", meta = (EditCondition = "bAdaptiveScan", ClampMin = "0.0", ClampMax = "180.0", Units = "deg"))
+	float AdaptiveRotationThreshold;
+
+	// Interactables further than this don't speed up scans. Uses UGASXInteractableRegistrySubsystem, or the current target if there is no registry.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive", meta = (EditCondition = "bAdaptiveScan", ClampMin = "0.0", Units = "cm"))
+	float AdaptiveCoarseRadius;
+
+	// Scan period when an interactable is right at the avatar. TimerPeriod is used at AdaptiveCoarseRadius.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive", meta = (EditCondition = "bAdaptiveScan", ClampMin = "0.0", Units = "s"))
+	float AdaptiveMinPeriod;
+
+	// Scan period when no interactable is within AdaptiveCoarseRadius. Only used with UGASXInteractableRegistrySubsystem, TimerPeriod is used otherwise.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Adaptive", meta = (EditCondition = "bAdaptiveScan", ClampMin = "0.0", Units = "s"))
+	float AdaptiveMaxPeriod;
+
 	// Interaction ability's AbilityTag. This is used to check if interation ability can be triggered.
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable")
 	FGameplayTag InteractionAbilityTag;
@@ -62,8 +98,27 @@ public:
 	bool bBlockInteractionIfTargetWasLost;
 
 	// Used to look for target candidates.
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable")
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable", meta = (EditCondition = "!bUseInteractableRegistry"))
 	TSubclassOf<UGASXTargetType> TargetType;
+
+	// If true, candidates are the nearest interactables in UGASXInteractableRegistrySubsystem instead of the results of TargetType, and only a few of them are traced for line of sight.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Registry")
+	bool bUseInteractableRegistry;
+
+	// Max distance from the avatar view point to an interactable.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Registry", meta = (EditCondition = "bUseInteractableRegistry"))
+	float RegistryQueryRadius;
+
+	// Half angle of the cone around the avatar view direction. 180 means all around.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Registry", meta = (EditCondition = "bUseInteractableRegistry", ClampMin = "0.0", ClampMax = "180.0", Units = "deg"))
+	float RegistryQueryHalfAngle;
+
+	// Max number of available candidates traced for line of sight, nearest first. The nearest one in sight is the target. Unavailable candidates are skipped without a trace.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Registry", meta = (EditCondition = "bUseInteractableRegistry", ClampMin = "1"))
+	int32 MaxLineOfSightTraces;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|FindInteractable|Registry", meta = (EditCondition = "bUseInteractableRegistry"))
+	TEnumAsByte<ECollisionChannel> LineOfSightChannel;
 	
 protected:
 	FDelegateHandle DelegateHandle;
@@ -77,6 +132,24 @@ protected:
 	bool bIsInteractionBlocked = false;
 
 	FGameplayAbilityTargetDataHandle InteractingTargetData;
+
+	// Scratch buffers reused by every scan, so that steady state scans don't allocate.
+	TArray<FHitResult> ScratchHitResults;
+	TArray<AActor*> ScratchActors;
+	FGameplayAbilityTargetDataHandle ScratchTargetData;
+
+	// Handles of abilities with InteractionAbilityTag, rebuilt when abilities are given or removed.
+	TArray<FGameplayAbilitySpecHandle> InteractionAbilityHandles;
+	uint32 InteractionAbilitiesGeneration = 0;
+
+	// Adaptive scan state. See bAdaptiveScan.
+	float CurrentScanPeriod = 0.f;
+	FVector LastScanViewLocation = FVector::ZeroVector;
+	FVector LastScanViewDirection = FVector::ZeroVector;
+
+	// Interactable component of the last found target, whose changes trigger a scan right away.
+	TWeakObjectPtr<class UGASXInteractableComponent> WatchedInteractable;
+	FDelegateHandle WatchedInteractableHandle;
 public:
 	UGA_Passive_FindInteractableBase();
 
@@ -87,10 +160,37 @@ public:
 	virtual void InputReleased(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) override;
 	// End of UGameplayAbility interface
 
+	// Looks for a target once. Called by the timer or UGASXInteractionSubsystem.
+	void RunInteractionScan() { TickFindInteractable(); }
+
+	// Current time between scans. TimerPeriod unless bAdaptiveScan.
+	float GetScanPeriod() const { return bAdaptiveScan && CurrentScanPeriod > 0.f ? CurrentScanPeriod : TimerPeriod; }
+
 protected:
 	UFUNCTION()
 	virtual void TickFindInteractable();
 
+	// Returns true if the avatar view barely changed since the last scan and the last target is static and still available.
+	bool CanReuseLastResult();
+
+	// Updates CurrentScanPeriod from the distance to the nearest interactable, and the timer if scans are not scheduled by UGASXInteractionSubsystem.
+	void UpdateAdaptiveScanPeriod();
+
+	// Returns true if any ability with InteractionAbilityTag satisfies its tag requirements.
+	bool HasActivatableInteractionAbility();
+
+	// Call the Blueprint event if it's implemented in Blueprint, or the native implementation directly otherwise.
+	bool DispatchTryFindTargetInteractable(FGameplayAbilityTargetDataHandle& OutTargetDataHandle);
+	bool DispatchGetTargets(TArray<FHitResult>& OutHitResults);
+	bool DispatchIsTargetDataValid(const FGameplayAbilityTargetDataHandle& InTargetData);
+
+	// Checks a hit with IsTargetDataValid(), without making target data unless IsTargetDataValid() is implemented in Blueprint.
+	bool IsHitResultValid(const FHitResult& HitResult);
+
+	// Starts listening to the UGASXInteractableComponent of TargetActor, if any, and stops listening to the previous one.
+	void WatchInteractable(AActor* TargetActor);
+	void OnWatchedInteractableChanged(class UGASXInteractableComponent* InteractableComponent);
+
 	virtual void OnFoundTarget(const FGameplayAbilityTargetDataHandle& FoundData);
 	virtual void OnLostTarget();
 
@@ -109,6 +209,9 @@ protected:
 	bool GetTargets(TArray<FHitResult>& OutHitResults);
 	virtual bool GetTargets_Implementation(TArray<FHitResult>& OutHitResults);
 
+	// Finds the nearest available interactable in sight using UGASXInteractableRegistrySubsystem. Used by TryFindTargetInteractable() if bUseInteractableRegistry.
+	virtual bool FindTargetFromRegistry(FGameplayAbilityTargetDataHandle& OutTargetDataHandle);
+
 	UFUNCTION(BlueprintCallable, Category = "Ability|FindInteractable")
 	bool MakeValidTargetDataFromHitResult(const FHitResult& InHitResult, FGameplayAbilityTargetDataHandle& OutValidTargetData);
 
@@ -124,4 +227,11 @@ protected:
 	bool IsInteractionBlocked() const { return bIsInteractionBlocked; }
 
 	FString MakeTargetDataMessage(const FGameplayAbilityTargetDataHandle& InTargetDataHandle);
+
+private:
+	void CacheBlueprintOverrides();
+
+	bool bBlueprintTryFindTargetInteractable = false;
+	bool bBlueprintGetTargets = false;
+	bool bBlueprintIsTargetDataValid = false;
 };
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameplayAbilities/GASXGameplayAbility.h"
+#include "Interaction/GASXInteractionSubsystem.h"
 #include "GA_PerformInteractBase.generated.h"
 
 /**
@@ -49,6 +50,28 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract")
 	FGameplayTag InteractableInteractTag;
 
+	// If true, the server checks distance and line of sight to targets chosen by remote clients before interacting.
+	// Needed if GA_Passive_FindInteractableBase::bScanOnOwningClientOnly is used, as the server then never looks for targets itself.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation")
+	bool bValidateClientTarget = true;
+
+	// Max distance from the avatar to the bounds of the target component.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation", meta = (EditCondition = "bValidateClientTarget", ClampMin = "0.0", Units = "cm"))
+	float MaxInteractionDistance = 400.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation", meta = (EditCondition = "bValidateClientTarget"))
+	bool bRequireLineOfSight = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation", meta = (EditCondition = "bValidateClientTarget && bRequireLineOfSight"))
+	TEnumAsByte<ECollisionChannel> LineOfSightChannel = ECC_Visibility;
+
+	// The last validation result is reused for the same target for this long, as long as the avatar stays within ValidationCacheTolerance of where it was validated.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation", meta = (EditCondition = "bValidateClientTarget", ClampMin = "0.0", Units = "s"))
+	float ValidationCacheTime = 0.5f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability|PerformInteract|ServerValidation", meta = (EditCondition = "bValidateClientTarget", ClampMin = "0.0", Units = "cm"))
+	float ValidationCacheTolerance = 50.f;
+
 protected:
 	FGameplayAbilityTargetDataHandle CurrentTargetData;
 	FGameplayAbilitySpecHandle InteractableAbilityHandle;
@@ -56,6 +79,15 @@ protected:
 	bool bIsInteracting = false;
 	bool bShouldActivateAbilityOnPreInteract = false;
 
+	// Hold before PerformMainInteraction(), run by UGASXInteractionSubsystem.
+	FGASXInteractionHoldHandle InteractionHoldHandle;
+
+	// Last server validation. See ValidateClientTarget().
+	TWeakObjectPtr<UPrimitiveComponent> ValidatedComponent;
+	FVector ValidatedAvatarLocation = FVector::ZeroVector;
+	double ValidatedTime = -1.0;
+	bool bLastValidationResult = false;
+
 public:
 	UGA_PerformInteractBase();
 
@@ -69,6 +101,15 @@ protected:
 
 	void OnEndInteractionEvent(const FGameplayEventData* Payload);
 
+	void CancelInteractionHold();
+
+public:
+	// Progress of the hold before the main interaction, from 0 to 1. -1 if not holding.
+	UFUNCTION(BlueprintPure, Category = "Ability|PerformInteract")
+	float GetInteractionHoldProgress() const;
+
+protected:
+
 	UFUNCTION(BlueprintCallable, Category = "Ability|PerformInteract")
 	bool GetCurrentTargetInfo(AActor*& InteractableActor, class UPrimitiveComponent*& InteractableComponent);
 
@@ -77,6 +118,9 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Ability|PerformInteract")
 	void CancelInteraction();
 
+	// On the server, checks distance and line of sight to a target chosen by a remote client. Always true otherwise.
+	virtual bool ValidateClientTarget(const FGameplayAbilityTargetDataHandle& InTargetData);
+
 	// Checks if InTargetData is valid as a target.
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Ability|PerformInteract")
 	bool IsTargetDataValid(const FGameplayAbilityTargetDataHandle& InTargetData);
@@ -0,0 +1,92 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GameplayEffectTypes.h"
+#include "GASXDataTypes.h"
+#include "GASXAreaEffectComponent.generated.h"
+
+class UAbilitySystemComponent;
+class UPrimitiveComponent;
+class UShapeComponent;
+
+/**
+ * Applies the effects of EffectContainer to ASCs while their avatar overlaps a shape component of the owner, and removes them when it leaves.
+ * Targets are tracked from overlap events, so the area is never re-queried. Attach the shape to a moving actor for an aura.
+ * TargetType of EffectContainer is not used, the shape decides the targets. Use periodic effects for damage or healing over time.
+ * Runs on the server only.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXAreaEffectComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	FGASXGameplayEffectContainer EffectContainer;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	float EffectLevel = 1.f;
+
+	// Name of the shape component of the owner to use as the area. If None, the first shape component found is used.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	FName ShapeComponentName;
+
+	// If false, effects applied on enter are kept after leaving, e.g. for a debuff with its own duration.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	bool bRemoveEffectsOnExit = true;
+
+	// If false, the owner and its instigator are never affected. Turn this on for an aura that also affects its owner.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	bool bAffectOwner = false;
+
+	// Tag requirements for the target ASC. Only checked when it enters, targets already inside are not re-evaluated when their tags change.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	FGameplayTagRequirements TargetTagRequirements;
+
+public:
+	UGASXAreaEffectComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of UActorComponent interface
+
+	// Removes effects from every target and applies them again with the current settings, e.g. after EffectLevel changed.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "AreaEffect")
+	void RefreshEffects();
+
+	UFUNCTION(BlueprintPure, Category = "AreaEffect")
+	int32 GetNumAffectedTargets() const { return Targets.Num(); }
+
+protected:
+	struct FTarget
+	{
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+		TArray<FActiveGameplayEffectHandle, TInlineAllocator<2>> EffectHandles;
+
+		// Components of the actor overlapping the shape. The actor leaves when the last one stops overlapping.
+		TArray<TWeakObjectPtr<UPrimitiveComponent>, TInlineAllocator<2>> OverlappingComponents;
+	};
+
+	TWeakObjectPtr<UShapeComponent> ShapeComponent;
+
+	// Affected actors only. Keyed by the overlapping actor, not the ASC, as that's what overlap events tell.
+	TMap<TObjectKey<AActor>, FTarget> Targets;
+
+	// Built once and applied to every target.
+	TArray<FGameplayEffectSpecHandle, TInlineAllocator<2>> EffectSpecs;
+
+	UFUNCTION()
+	void OnShapeBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnShapeEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void BuildEffectSpecs();
+	void ApplyEffects(FTarget& Target);
+	void RemoveEffects(FTarget& Target);
+	bool CanAffect(const AActor* Actor, const UAbilitySystemComponent* AbilitySystemComponent) const;
+};
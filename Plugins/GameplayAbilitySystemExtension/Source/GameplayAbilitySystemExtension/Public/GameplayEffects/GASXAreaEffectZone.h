@@ -0,0 +1,33 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GASXAreaEffectZone.generated.h"
+
+class USphereComponent;
+class UGASXAreaEffectComponent;
+
+/**
+ * A sphere that applies effects to whoever stands in it, e.g. a ground AoE. See UGASXAreaEffectComponent.
+ * Set the instigator when spawning, so that effects are attributed to it. Use LifeSpan for a zone that expires.
+ */
+UCLASS(Blueprintable)
+class GAMEPLAYABILITYSYSTEMEXTENSION_API AGASXAreaEffectZone : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGASXAreaEffectZone(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	USphereComponent* GetAreaComponent() const { return AreaComponent; }
+	UGASXAreaEffectComponent* GetAreaEffectComponent() const { return AreaEffectComponent; }
+
+protected:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	TObjectPtr<USphereComponent> AreaComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AreaEffect")
+	TObjectPtr<UGASXAreaEffectComponent> AreaEffectComponent;
+};
@@ -0,0 +1,58 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GASXInteractableComponent.generated.h"
+
+class UGASXInteractableComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FGASXInteractableChangedDelegate, UGASXInteractableComponent*);
+
+/**
+ * Native interaction state of an actor implementing IGASXInteractable.
+ * If an interactable has this component, availability and duration are read from these replicated fields instead of calling the interface through reflection.
+ * The interface is still used for actors without this component, and for Interact() etc. The component is ignored on actors that don't implement IGASXInteractable.
+ * Set the fields through the setters on the server, so that they are pushed to clients and OnInteractableChanged is broadcast.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXInteractableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_InteractionState, Category = "Interactable")
+	bool bAvailableForInteraction = true;
+
+	// How long the interaction key must be held. 0 interacts on press.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_InteractionState, Category = "Interactable", meta = (ClampMin = "0.0", Units = "s"))
+	float InteractionDuration = 0.f;
+
+public:
+	// Broadcast on both server and clients when any of the fields above changes.
+	FGASXInteractableChangedDelegate OnInteractableChanged;
+
+public:
+	UGASXInteractableComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// UObject interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// End of UObject interface
+
+	// Returns the interactable component of Actor, if any.
+	static UGASXInteractableComponent* FindInteractableComponent(const AActor* Actor);
+
+	bool IsAvailableForInteraction() const { return bAvailableForInteraction; }
+	float GetInteractionDuration() const { return InteractionDuration; }
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Interactable")
+	void SetAvailableForInteraction(bool bAvailable);
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Interactable")
+	void SetInteractionDuration(float Duration);
+
+protected:
+	UFUNCTION()
+	void OnRep_InteractionState();
+};
@@ -0,0 +1,97 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GASXInteractableRegistrySubsystem.generated.h"
+
+class ULevel;
+
+struct FGASXInteractableCandidate
+{
+	AActor* Actor = nullptr;
+	UPrimitiveComponent* Component = nullptr;
+	FVector Location = FVector::ZeroVector;
+	float DistanceSquared = 0.f;
+};
+
+/**
+ * Keeps every actor implementing IGASXInteractable in a uniform grid, so that the nearest interactables can be found without querying the physics scene.
+ * Actors are registered automatically when the world begins play, when they are spawned and when their level is streamed in, and unregistered when destroyed or streamed out.
+ * Static interactables are placed once. Movable ones are moved between cells at most once per frame, the first time the registry is queried.
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXInteractableRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	// UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// End of UWorldSubsystem interface
+
+	// Registers Actor if it implements IGASXInteractable. Component defaults to the root primitive component, or the first primitive component.
+	void RegisterInteractable(AActor* Actor, UPrimitiveComponent* Component = nullptr);
+	void UnregisterInteractable(AActor* Actor);
+
+	int32 GetNumInteractables() const { return Entries.Num(); }
+
+	/**
+	 * Finds up to MaxCandidates interactables within Radius of Origin, nearest first.
+	 * If CosHalfAngle is greater than -1, only candidates within that cone around Direction are returned.
+	 * Availability is not checked.
+	 */
+	template<typename AllocatorType>
+	void FindNearestInteractables(const FVector& Origin, const FVector& Direction, float Radius, float CosHalfAngle, int32 MaxCandidates, TArray<FGASXInteractableCandidate, AllocatorType>& OutCandidates)
+	{
+		GatherNearestInteractables(Origin, Direction, Radius, CosHalfAngle, MaxCandidates);
+		OutCandidates.Append(QueryCandidates);
+	}
+
+protected:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TObjectKey<AActor> ActorKey;
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		FVector Location = FVector::ZeroVector;
+		FIntVector Cell = FIntVector::ZeroValue;
+		bool bMovable = false;
+	};
+
+	TSparseArray<FEntry> Entries;
+	TMap<TObjectKey<AActor>, int32> EntryByActor;
+	TMap<FIntVector, TArray<int32, TInlineAllocator<8>>> Cells;
+	TArray<int32> MovableEntries;
+	uint64 LastUpdateFrame = 0;
+
+	// Result of the last query, nearest first. Kept to avoid allocations every query.
+	TArray<FGASXInteractableCandidate> QueryCandidates;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	FIntVector GetCell(const FVector& Location) const;
+	void AddToCell(int32 EntryIndex);
+	void RemoveFromCell(int32 EntryIndex);
+	void RemoveEntry(int32 EntryIndex);
+	void UpdateMovableEntries();
+
+	// Fills QueryCandidates for FindNearestInteractables().
+	void GatherNearestInteractables(const FVector& Origin, const FVector& Direction, float Radius, float CosHalfAngle, int32 MaxCandidates);
+
+	void RegisterLevel(ULevel* Level);
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+};
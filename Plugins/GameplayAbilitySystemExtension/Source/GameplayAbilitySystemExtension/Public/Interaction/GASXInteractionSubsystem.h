@@ -0,0 +1,145 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GASXInteractionSubsystem.generated.h"
+
+class UGA_Passive_FindInteractableBase;
+
+// Identifies a hold started by UGASXInteractionSubsystem::StartHold(). Stays safe to use after the hold completed or was canceled.
+struct FGASXInteractionHoldHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+	void Invalidate() { Index = INDEX_NONE; Serial = 0; }
+};
+
+struct FGASXInteractionHoldProgress
+{
+	FGASXInteractionHoldHandle Handle;
+	TWeakObjectPtr<const AActor> Instigator;
+
+	// From 0 to 1
+	float Progress = 0.f;
+};
+
+// Broadcast once per frame with every running hold, so that UI doesn't have to poll each ability.
+DECLARE_MULTICAST_DELEGATE_OneParam(FGASXInteractionHoldProgressDelegate, TConstArrayView<FGASXInteractionHoldProgress>);
+
+/**
+ * Runs the scans of every UGA_Passive_FindInteractableBase in the world, instead of each ability running its own timer.
+ * Scans are spread across frames: each scanner gets a random phase when registered, and scans that are due are run under a per frame time budget (gasx.interaction.ScanBudgetUs).
+ * When over budget, locally controlled avatars go first, then avatars that moved since their last scan, then the most overdue ones.
+ * Scans that didn't fit are left for next frame. At least one scan runs every frame, so the backlog always drains.
+ * Also runs hold-to-interact timers on a timing wheel, so that many holds at once don't each register a timer with the timer manager.
+ * Also keeps the scan cost of every scanner, including the ones running on their own timer, for "stat GASXInteraction", the CSV profiler and gasx.interaction.Report.
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXInteractionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// End of UWorldSubsystem interface
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+	void RegisterScanner(UGA_Passive_FindInteractableBase* Ability);
+	void UnregisterScanner(UGA_Passive_FindInteractableBase* Ability);
+
+	// Number of scans that were due but didn't fit in the budget last frame.
+	int32 GetNumOverdueScans() const { return NumOverdueScans; }
+
+	// How late the most overdue scan was last frame, in seconds.
+	float GetMaxScanLateness() const { return MaxScanLateness; }
+
+	// Called by UGA_Passive_FindInteractableBase after each scan. bSkipped if it returned early, e.g. reusing the last result.
+	void RecordScan(const UGA_Passive_FindInteractableBase* Ability, double Seconds, bool bSkipped);
+
+	// Logs the NumScanners scanners that spent the most time scanning so far.
+	void LogCostliestScanners(int32 NumScanners) const;
+
+	// Calls OnCompleted after Duration seconds, unless canceled first. Instigator is only passed to OnHoldProgress.
+	FGASXInteractionHoldHandle StartHold(float Duration, FSimpleDelegate&& OnCompleted, const AActor* Instigator = nullptr);
+
+	// Cancels the hold if it's still running, and invalidates Handle.
+	void CancelHold(FGASXInteractionHoldHandle& Handle);
+
+	bool IsHoldRunning(const FGASXInteractionHoldHandle& Handle) const { return FindHold(Handle) != nullptr; }
+
+	// From 0 to 1, or -1 if the hold is not running.
+	float GetHoldProgress(const FGASXInteractionHoldHandle& Handle) const;
+
+	FGASXInteractionHoldProgressDelegate OnHoldProgress;
+
+protected:
+	struct FScanner
+	{
+		TWeakObjectPtr<UGA_Passive_FindInteractableBase> Ability;
+		double NextScanTime = 0.0;
+		FVector LastScanLocation = FVector::ZeroVector;
+	};
+
+	TArray<FScanner> Scanners;
+
+	struct FScanCost
+	{
+		TWeakObjectPtr<const AActor> Avatar;
+		int32 NumScans = 0;
+		int32 NumSkipped = 0;
+		double TotalSeconds = 0.0;
+		double MaxSeconds = 0.0;
+	};
+
+	// Removed when the scanner is unregistered.
+	TMap<TObjectKey<UGA_Passive_FindInteractableBase>, FScanCost> ScanCosts;
+
+	// Since last Tick, for the average scan time.
+	double FrameScanSeconds = 0.0;
+	int32 FrameNumScans = 0;
+
+	// Scratch array of due scanner indices, kept to avoid allocations every frame.
+	TArray<TPair<float, int32>> DueScanners;
+
+	bool bIsScanning = false;
+	int32 NumOverdueScans = 0;
+	float MaxScanLateness = 0.f;
+
+	// Higher runs first.
+	float GetScanPriority(const FScanner& Scanner, double Now) const;
+
+	struct FHold
+	{
+		FSimpleDelegate OnCompleted;
+		TWeakObjectPtr<const AActor> Instigator;
+		double StartTime = 0.0;
+		double EndTime = 0.0;
+		int64 EndTick = 0;
+		uint32 Serial = 0;
+	};
+
+	TSparseArray<FHold> Holds;
+
+	// Each slot holds the holds ending on the wheel ticks that map to it. Holds further than one rotation away stay until their tick comes around.
+	TArray<TArray<FGASXInteractionHoldHandle>> HoldWheel;
+
+	// Every tick up to here has been processed, except that the slot of the current tick is processed again next frame.
+	int64 LastHoldTick = INDEX_NONE;
+	uint32 NextHoldSerial = 1;
+
+	// Scratch arrays, kept to avoid allocations every frame.
+	TArray<FSimpleDelegate> CompletedHolds;
+	TArray<FGASXInteractionHoldProgress> HoldProgress;
+
+	const FHold* FindHold(const FGASXInteractionHoldHandle& Handle) const;
+	void TickHolds(double Now);
+};
@@ -0,0 +1,207 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Batched analytic tests of query shapes against capsules, 4 capsules at a time.
+ * Used for hitbox and lag compensation targeting, which test against simplified capsules instead of the physics scene.
+ */
+namespace GASXAnalyticGeometry
+{
+	/**
+	 * Capsules stored as separate arrays (structure of arrays). A and B are the end points of the capsule axis.
+	 * Arrays must have room for a multiple of 4 elements. Elements past Num are ignored.
+	 */
+	struct FCapsuleArrays
+	{
+		const float* AX = nullptr;
+		const float* AY = nullptr;
+		const float* AZ = nullptr;
+		const float* BX = nullptr;
+		const float* BY = nullptr;
+		const float* BZ = nullptr;
+		const float* Radius = nullptr;
+		int32 Num = 0;
+	};
+
+	struct FCapsuleHit
+	{
+		// Index into FCapsuleArrays
+		int32 Index = INDEX_NONE;
+
+		// Fraction along the query segment of its closest point to the capsule axis
+		float Time = 0.f;
+	};
+
+	FORCEINLINE VectorRegister4Float VectorClamp01(const VectorRegister4Float& Value)
+	{
+		return VectorMin(VectorMax(Value, VectorZeroFloat()), VectorOneFloat());
+	}
+
+	FORCEINLINE VectorRegister4Float VectorDot3(const VectorRegister4Float& AX, const VectorRegister4Float& AY, const VectorRegister4Float& AZ, const VectorRegister4Float& BX, const VectorRegister4Float& BY, const VectorRegister4Float& BZ)
+	{
+		return VectorMultiplyAdd(AX, BX, VectorMultiplyAdd(AY, BY, VectorMultiply(AZ, BZ)));
+	}
+
+	/**
+	 * Closest points between segment P + S * D, shared by all lanes, and segments A + T * (B - A), one per lane.
+	 * Based on the segment/segment test in Real-Time Collision Detection (Ericson), made branchless.
+	 * Returns the squared distance between the closest points. OutS and OutT are their fractions along each segment.
+	 */
+	FORCEINLINE VectorRegister4Float SegmentSegmentDistanceSquared(
+		const VectorRegister4Float& PX, const VectorRegister4Float& PY, const VectorRegister4Float& PZ,
+		const VectorRegister4Float& DX, const VectorRegister4Float& DY, const VectorRegister4Float& DZ,
+		const VectorRegister4Float& DD,
+		const VectorRegister4Float& AX, const VectorRegister4Float& AY, const VectorRegister4Float& AZ,
+		const VectorRegister4Float& BX, const VectorRegister4Float& BY, const VectorRegister4Float& BZ,
+		VectorRegister4Float& OutS, VectorRegister4Float& OutT)
+	{
+		const VectorRegister4Float Epsilon = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+
+		const VectorRegister4Float EX = VectorSubtract(BX, AX);
+		const VectorRegister4Float EY = VectorSubtract(BY, AY);
+		const VectorRegister4Float EZ = VectorSubtract(BZ, AZ);
+		const VectorRegister4Float RX = VectorSubtract(PX, AX);
+		const VectorRegister4Float RY = VectorSubtract(PY, AY);
+		const VectorRegister4Float RZ = VectorSubtract(PZ, AZ);
+
+		// Degenerate segments (points) are handled by clamping the squared lengths away from zero.
+		const VectorRegister4Float A = VectorMax(DD, Epsilon);
+		const VectorRegister4Float E = VectorMax(VectorDot3(EX, EY, EZ, EX, EY, EZ), Epsilon);
+		const VectorRegister4Float B = VectorDot3(DX, DY, DZ, EX, EY, EZ);
+		const VectorRegister4Float C = VectorDot3(DX, DY, DZ, RX, RY, RZ);
+		const VectorRegister4Float F = VectorDot3(EX, EY, EZ, RX, RY, RZ);
+
+		// Parallel segments pick S = 0
+		const VectorRegister4Float Denom = VectorSubtract(VectorMultiply(A, E), VectorMultiply(B, B));
+		const VectorRegister4Float SGeneral = VectorClamp01(VectorDivide(VectorSubtract(VectorMultiply(B, F), VectorMultiply(C, E)), VectorMax(Denom, Epsilon)));
+		VectorRegister4Float S = VectorSelect(VectorCompareGT(Denom, Epsilon), SGeneral, VectorZeroFloat());
+
+		const VectorRegister4Float T = VectorDivide(VectorMultiplyAdd(B, S, F), E);
+
+		// If T is out of range, clamp it and recompute S for the clamped T.
+		const VectorRegister4Float SIfTBelow = VectorClamp01(VectorDivide(VectorNegate(C), A));
+		const VectorRegister4Float SIfTAbove = VectorClamp01(VectorDivide(VectorSubtract(B, C), A));
+		S = VectorSelect(VectorCompareLT(T, VectorZeroFloat()), SIfTBelow, VectorSelect(VectorCompareGT(T, VectorOneFloat()), SIfTAbove, S));
+		OutS = S;
+		OutT = VectorClamp01(T);
+
+		const VectorRegister4Float DiffX = VectorSubtract(VectorMultiplyAdd(DX, S, PX), VectorMultiplyAdd(EX, OutT, AX));
+		const VectorRegister4Float DiffY = VectorSubtract(VectorMultiplyAdd(DY, S, PY), VectorMultiplyAdd(EY, OutT, AY));
+		const VectorRegister4Float DiffZ = VectorSubtract(VectorMultiplyAdd(DZ, S, PZ), VectorMultiplyAdd(EZ, OutT, AZ));
+		return VectorDot3(DiffX, DiffY, DiffZ, DiffX, DiffY, DiffZ);
+	}
+
+	// Appends lanes set in Mask to OutHits, skipping padding past Num.
+	template<typename AllocatorType>
+	FORCEINLINE void AppendHitLanes(int32 BaseIndex, int32 Num, const VectorRegister4Float& Mask, const VectorRegister4Float& Time, TArray<FCapsuleHit, AllocatorType>& OutHits)
+	{
+		uint32 Bits = (uint32)VectorMaskBits(Mask);
+		if (Bits == 0)
+		{
+			return;
+		}
+
+		alignas(16) float Times[4];
+		VectorStoreAligned(Time, Times);
+		while (Bits != 0)
+		{
+			const int32 Lane = (int32)FMath::CountTrailingZeros(Bits);
+			if (BaseIndex + Lane < Num)
+			{
+				OutHits.Add({ BaseIndex + Lane, Times[Lane] });
+			}
+			Bits &= Bits - 1;
+		}
+	}
+
+	/**
+	 * Sweeps a sphere of Radius from Start to End against capsules. Radius 0 is a ray, and Start == End is a sphere overlap.
+	 * Hits are appended in capsule order, not sorted by time.
+	 */
+	template<typename AllocatorType>
+	void SweepSphereAgainstCapsules(const FVector3f& Start, const FVector3f& End, float Radius, const FCapsuleArrays& Capsules, TArray<FCapsuleHit, AllocatorType>& OutHits)
+	{
+		const FVector3f Delta = End - Start;
+		const VectorRegister4Float PX = VectorSetFloat1(Start.X);
+		const VectorRegister4Float PY = VectorSetFloat1(Start.Y);
+		const VectorRegister4Float PZ = VectorSetFloat1(Start.Z);
+		const VectorRegister4Float DX = VectorSetFloat1(Delta.X);
+		const VectorRegister4Float DY = VectorSetFloat1(Delta.Y);
+		const VectorRegister4Float DZ = VectorSetFloat1(Delta.Z);
+		const VectorRegister4Float DD = VectorSetFloat1(Delta.SizeSquared());
+		const VectorRegister4Float QueryRadius = VectorSetFloat1(Radius);
+
+		for (int32 Index = 0; Index < Capsules.Num; Index += 4)
+		{
+			VectorRegister4Float S, T;
+			const VectorRegister4Float DistanceSquared = SegmentSegmentDistanceSquared(PX, PY, PZ, DX, DY, DZ, DD,
+				VectorLoad(Capsules.AX + Index), VectorLoad(Capsules.AY + Index), VectorLoad(Capsules.AZ + Index),
+				VectorLoad(Capsules.BX + Index), VectorLoad(Capsules.BY + Index), VectorLoad(Capsules.BZ + Index),
+				S, T);
+
+			const VectorRegister4Float HitRadius = VectorAdd(VectorLoad(Capsules.Radius + Index), QueryRadius);
+			const VectorRegister4Float Mask = VectorCompareLE(DistanceSquared, VectorMultiply(HitRadius, HitRadius));
+			AppendHitLanes(Index, Capsules.Num, Mask, S, OutHits);
+		}
+	}
+
+	/**
+	 * Tests capsules against a cone from Apex along unit Direction.
+	 * The capsule point closest to the cone axis is tested against the cone inflated by the capsule radius.
+	 * This is a conservative approximation that is good enough for gameplay targeting.
+	 */
+	template<typename AllocatorType>
+	void ConeAgainstCapsules(const FVector3f& Apex, const FVector3f& Direction, float Range, float HalfAngleRadians, const FCapsuleArrays& Capsules, TArray<FCapsuleHit, AllocatorType>& OutHits)
+	{
+		const FVector3f Axis = Direction * Range;
+		const VectorRegister4Float PX = VectorSetFloat1(Apex.X);
+		const VectorRegister4Float PY = VectorSetFloat1(Apex.Y);
+		const VectorRegister4Float PZ = VectorSetFloat1(Apex.Z);
+		const VectorRegister4Float DX = VectorSetFloat1(Axis.X);
+		const VectorRegister4Float DY = VectorSetFloat1(Axis.Y);
+		const VectorRegister4Float DZ = VectorSetFloat1(Axis.Z);
+		const VectorRegister4Float DD = VectorSetFloat1(Axis.SizeSquared());
+		const VectorRegister4Float DirX = VectorSetFloat1(Direction.X);
+		const VectorRegister4Float DirY = VectorSetFloat1(Direction.Y);
+		const VectorRegister4Float DirZ = VectorSetFloat1(Direction.Z);
+		const VectorRegister4Float RangeVector = VectorSetFloat1(Range);
+		const VectorRegister4Float InvRange = VectorSetFloat1(Range > 0.f ? 1.f / Range : 0.f);
+		const VectorRegister4Float CosHalfAngle = VectorSetFloat1(FMath::Cos(HalfAngleRadians));
+		const VectorRegister4Float SinHalfAngle = VectorSetFloat1(FMath::Sin(HalfAngleRadians));
+
+		for (int32 Index = 0; Index < Capsules.Num; Index += 4)
+		{
+			const VectorRegister4Float AX = VectorLoad(Capsules.AX + Index);
+			const VectorRegister4Float AY = VectorLoad(Capsules.AY + Index);
+			const VectorRegister4Float AZ = VectorLoad(Capsules.AZ + Index);
+			const VectorRegister4Float BX = VectorLoad(Capsules.BX + Index);
+			const VectorRegister4Float BY = VectorLoad(Capsules.BY + Index);
+			const VectorRegister4Float BZ = VectorLoad(Capsules.BZ + Index);
+			const VectorRegister4Float CapsuleRadius = VectorLoad(Capsules.Radius + Index);
+
+			VectorRegister4Float S, T;
+			SegmentSegmentDistanceSquared(PX, PY, PZ, DX, DY, DZ, DD, AX, AY, AZ, BX, BY, BZ, S, T);
+
+			// Capsule axis point closest to the cone axis, relative to the apex
+			const VectorRegister4Float VX = VectorSubtract(VectorMultiplyAdd(VectorSubtract(BX, AX), T, AX), PX);
+			const VectorRegister4Float VY = VectorSubtract(VectorMultiplyAdd(VectorSubtract(BY, AY), T, AY), PY);
+			const VectorRegister4Float VZ = VectorSubtract(VectorMultiplyAdd(VectorSubtract(BZ, AZ), T, AZ), PZ);
+
+			const VectorRegister4Float LengthSquared = VectorDot3(VX, VY, VZ, VX, VY, VZ);
+			const VectorRegister4Float Along = VectorDot3(VX, VY, VZ, DirX, DirY, DirZ);
+			const VectorRegister4Float Perpendicular = VectorSqrt(VectorMax(VectorSubtract(LengthSquared, VectorMultiply(Along, Along)), VectorZeroFloat()));
+
+			// Within range, not behind the apex, and no further than the capsule radius outside the cone surface.
+			const VectorRegister4Float MaxLength = VectorAdd(RangeVector, CapsuleRadius);
+			VectorRegister4Float Mask = VectorCompareLE(LengthSquared, VectorMultiply(MaxLength, MaxLength));
+			Mask = VectorBitwiseAnd(Mask, VectorCompareGE(Along, VectorNegate(CapsuleRadius)));
+			Mask = VectorBitwiseAnd(Mask, VectorCompareLE(VectorSubtract(VectorMultiply(Perpendicular, CosHalfAngle), VectorMultiply(Along, SinHalfAngle)), CapsuleRadius));
+
+			// Capsules reach up to their radius past the range, so clamp to keep the time a fraction of the cone length.
+			AppendHitLanes(Index, Capsules.Num, Mask, VectorClamp01(VectorMultiply(VectorSqrt(LengthSquared), InvRange)), OutHits);
+		}
+	}
+}
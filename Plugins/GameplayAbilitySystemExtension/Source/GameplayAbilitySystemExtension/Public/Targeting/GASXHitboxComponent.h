@@ -0,0 +1,84 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GASXHitboxComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+/** A capsule attached to a bone. The capsule axis is the local Z axis. */
+USTRUCT(BlueprintType)
+struct GAMEPLAYABILITYSYSTEMEXTENSION_API FGASXHitboxCapsule
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+	FName BoneName;
+
+	// Center in bone space
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+	FVector Center = FVector::ZeroVector;
+
+	// Rotation in bone space
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox", meta = (ClampMin = "0"))
+	float Radius = 10.f;
+
+	// Length of the cylinder part. 0 makes a sphere.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox", meta = (ClampMin = "0"))
+	float Length = 0.f;
+};
+
+/**
+ * Registers simplified capsules of a character with UGASXHitboxSubsystem, for analytic hitbox targeting.
+ * Capsules follow bones of the first skeletal mesh component of the owner.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXHitboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Capsules to register. If empty and bBuildFromPhysicsAsset is true, capsules are built from sphyls and spheres in the physics asset of the mesh instead.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hitbox")
+	TArray<FGASXHitboxCapsule> Capsules;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hitbox")
+	bool bBuildFromPhysicsAsset = true;
+
+public:
+	UGASXHitboxComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of UActorComponent interface
+
+	USkeletalMeshComponent* GetMeshComponent() const { return MeshComponent.Get(); }
+
+	// Capsules in use. Capsules if set, otherwise the ones built from the physics asset.
+	const TArray<FGASXHitboxCapsule>& GetCapsules() const { return Capsules.IsEmpty() ? GeneratedCapsules : Capsules; }
+
+	// Bone index of each capsule in GetCapsules(), INDEX_NONE if the capsule follows the mesh component itself.
+	const TArray<int32>& GetBoneIndices() const { return BoneIndices; }
+
+	// Gets end points of the capsule axis and the radius in world space.
+	void GetWorldCapsule(int32 CapsuleIndex, FVector& OutA, FVector& OutB, float& OutRadius) const;
+
+	// Rebuilds capsules and bone indices and re-registers them. Call this if the mesh, its physics asset or Capsules change at runtime.
+	UFUNCTION(BlueprintCallable, Category = "Hitbox")
+	void RefreshCapsuleLayout();
+
+protected:
+	TWeakObjectPtr<USkeletalMeshComponent> MeshComponent;
+	TArray<int32> BoneIndices;
+
+	// Built from the physics asset by RefreshCapsuleLayout(). Kept apart from Capsules so that a later refresh can build them again from another mesh.
+	TArray<FGASXHitboxCapsule> GeneratedCapsules;
+
+	void BuildCapsulesFromPhysicsAsset();
+};
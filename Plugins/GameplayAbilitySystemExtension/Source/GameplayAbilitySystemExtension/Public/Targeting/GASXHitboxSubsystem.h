@@ -0,0 +1,64 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Targeting/GASXAnalyticGeometry.h"
+#include "GASXHitboxSubsystem.generated.h"
+
+class UGASXHitboxComponent;
+
+struct FGASXHitboxHit
+{
+	UGASXHitboxComponent* Component = nullptr;
+	int32 CapsuleIndex = INDEX_NONE;
+
+	// Fraction along the query of the closest approach to the capsule
+	float Time = 0.f;
+};
+
+/**
+ * Keeps world space capsules of all UGASXHitboxComponents in flat arrays and tests queries against them analytically, without the physics scene.
+ * Capsules are refreshed from bone transforms at most once per frame, the first time they are queried.
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXHitboxSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// End of USubsystem interface
+
+	void RegisterHitboxComponent(UGASXHitboxComponent* Component);
+	void UnregisterHitboxComponent(UGASXHitboxComponent* Component);
+
+	/** Sweeps a sphere against all capsules. Radius 0 is a ray, and Start == End is a sphere overlap. */
+	void SweepSphere(const FVector& Start, const FVector& End, float Radius, TArray<FGASXHitboxHit>& OutHits);
+
+	/** Tests all capsules against a cone from Apex along Direction. */
+	void OverlapCone(const FVector& Apex, const FVector& Direction, float Range, float HalfAngleDegrees, TArray<FGASXHitboxHit>& OutHits);
+
+	// Updates world space capsules from bone transforms if it hasn't been done this frame.
+	void RefreshCapsules();
+
+	int32 GetNumCapsules() const { return CapsuleComponentIndices.Num(); }
+
+protected:
+	TArray<TWeakObjectPtr<UGASXHitboxComponent>> Components;
+
+	// World space capsules as structure of arrays, padded to a multiple of 4
+	TArray<float> AX, AY, AZ, BX, BY, BZ, Radius;
+
+	// Per capsule: index into Components and index into the component's capsules
+	TArray<int32> CapsuleComponentIndices;
+	TArray<int32> CapsuleLocalIndices;
+
+	bool bLayoutDirty = false;
+	uint64 LastRefreshFrame = MAX_uint64;
+
+	void RebuildLayout();
+	void AppendHits(TConstArrayView<GASXAnalyticGeometry::FCapsuleHit> CapsuleHits, TArray<FGASXHitboxHit>& OutHits) const;
+};
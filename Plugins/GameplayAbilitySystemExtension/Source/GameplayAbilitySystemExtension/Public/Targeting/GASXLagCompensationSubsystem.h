@@ -0,0 +1,83 @@
+// Copyright 2024 Toranosuke Ichikawa
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GASXLagCompensationSubsystem.generated.h"
+
+struct FGASXRewoundHit
+{
+	AActor* Actor = nullptr;
+
+	// Fraction along the query of the closest approach to the capsule
+	float Time = 0.f;
+
+	// Rewound capsule
+	FVector CapsuleA = FVector::ZeroVector;
+	FVector CapsuleB = FVector::ZeroVector;
+	float CapsuleRadius = 0.f;
+};
+
+/**
+ * Server side history of actor collision capsules, for lag compensated targeting.
+ * Every frame, the simple collision cylinder of each tracked actor is recorded into a ring buffer stored as structure of arrays.
+ * Each frame is one block of slots, and each tracked actor keeps its slot, so recording is a single pass without allocations.
+ * Pawns are tracked automatically. Other actors can be registered with RegisterActor().
+ */
+UCLASS()
+class GAMEPLAYABILITYSYSTEMEXTENSION_API UGASXLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	// UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// End of UWorldSubsystem interface
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+	void RegisterActor(AActor* Actor);
+	void UnregisterActor(AActor* Actor);
+	bool IsActorTracked(const AActor* Actor) const { return Actor && SlotByActor.Contains(Actor); }
+
+	// Time range of the recorded history, in world time seconds. Returns false if nothing is recorded yet.
+	bool GetHistoryTimeRange(double& OutOldest, double& OutNewest) const;
+
+	/**
+	 * Sweeps a sphere against tracked actors as they were at Timestamp (world time seconds), interpolating between recorded frames.
+	 * Timestamp is clamped to the recorded history. Only actors whose rewound capsule is inside the bounds of the sweep are tested.
+	 * Radius 0 is a ray.
+	 */
+	void SweepSphereAtTime(double Timestamp, const FVector& Start, const FVector& End, float Radius, TArray<FGASXRewoundHit>& OutHits) const;
+
+protected:
+	// Ring buffer of frames. Index of a slot in a frame is Frame * SlotCapacity + Slot.
+	TArray<double> FrameTimes;
+	TArray<float> AX, AY, AZ, BX, BY, BZ, Radius;
+	int32 HistoryLength = 0;
+	int32 SlotCapacity = 0;
+	int32 NewestFrame = INDEX_NONE;
+	int32 NumRecordedFrames = 0;
+
+	TArray<TWeakObjectPtr<AActor>> SlotActors;
+	TArray<TObjectKey<AActor>> SlotKeys;
+	TArray<int32> FreeSlots;
+	TMap<TObjectKey<AActor>, int32> SlotByActor;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	void RecordFrame();
+	void Reallocate(int32 NewHistoryLength, int32 NewSlotCapacity);
+	void FreeSlot(int32 Slot);
+	void OnActorSpawned(AActor* Actor);
+};